@@ -24,10 +24,10 @@ std::string getHiddenInput(const std::string_view html) {
 }
 
 // Fetches and saves the user's registration time if it hasn't already been saved.
-void fetchRegistrationTime(Task& task) {
+void fetchRegistrationTime(Task& task, const SessionManager& sessionManager) {
     if (task.scheduler.getRegistrationTimePoint() == std::chrono::system_clock::time_point{}) {
-        task.scheduler.saveRegistrationTime(task.sessionManager.getSession(), task.config.termCode,
-            task.sessionManager.uniqueSessionId);
+        task.scheduler.saveRegistrationTime(sessionManager.getSession(), task.config.termCode,
+            sessionManager.uniqueSessionId);
     }
 }
 
@@ -95,10 +95,15 @@ bool alreadyAuthenticated(cpr::Session& session) {
 } // namespace
 
 void authenticate(Task& task) {
+    authenticate(task, task.sessionManager);
+}
+
+void authenticate(Task& task, SessionManager& sessionManager) {
     task.scheduler.throwIfStopped();
 
-    if (alreadyAuthenticated(task.sessionManager.getSession())) {
+    if (alreadyAuthenticated(sessionManager.getSession())) {
         task.logger.debug("Already authenticated. Skipping login.");
+        sessionManager.navigation.verifiedAt = std::chrono::steady_clock::now();
         return;
     }
 
@@ -107,23 +112,24 @@ void authenticate(Task& task) {
         try {
             task.logger.debug("Signing in...");
 
-            visitClassRegistration(task.sessionManager.getSession()); // Prompts login
-            ssbLoginRedirect(task.sessionManager);
+            visitClassRegistration(sessionManager.getSession()); // Prompts login
+            ssbLoginRedirect(sessionManager);
 
-            if (!idpSSO(task.sessionManager)) {
+            if (!idpSSO(sessionManager)) {
                 task.logger.debug("Received authentication failure during idpSSO.");
-                task.sessionManager.resetSession();
+                sessionManager.resetSession();
                 --attempts;
                 continue;
             }
 
-            getLoginPage(task.sessionManager.getSession());
-            login(task.sessionManager, task.config.cwid, task.config.password);
-            selfServiceSSO(task.sessionManager);
-            visitRegistrationDashboard(task.sessionManager.getSession());
-            fetchRegistrationTime(task);
+            getLoginPage(sessionManager.getSession());
+            login(sessionManager, task.config.cwid, task.config.password);
+            selfServiceSSO(sessionManager);
+            visitRegistrationDashboard(sessionManager.getSession());
+            fetchRegistrationTime(task, sessionManager);
 
-            task.sessionManager.generateUniqueSessionId();
+            sessionManager.generateUniqueSessionId();
+            sessionManager.navigation = {.verifiedAt = std::chrono::steady_clock::now()};
             task.logger.info("Successfully signed in.");
             break;
         } catch (const UnrecoverableException& e) {
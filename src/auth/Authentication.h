@@ -6,4 +6,7 @@
 // Authenticates user and saves registration time. Doesn't do anything if already authenticated.
 void authenticate(Task& task);
 
+// Same as above, but signs in the given session manager (e.g. one of the task's hedged sessions).
+void authenticate(Task& task, SessionManager& sessionManager);
+
 #endif // AUTHENTICATION_H
\ No newline at end of file
@@ -0,0 +1,115 @@
+#include "control/ControlClient.h"
+#include "control/ControlProtocol.h"
+#include "util/Utility.h"
+
+#include <fmt/format.h>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include <array>
+#include <cstring>
+
+ControlClient::ControlClient(std::filesystem::path socketPath) : m_socketPath{std::move(socketPath)} {}
+
+ControlClient::ControlClient(ControlClient&& other) noexcept
+    : m_socketPath{std::move(other.m_socketPath)}, m_fd{other.m_fd}, m_pending{std::move(other.m_pending)} {
+    other.m_fd = -1;
+}
+
+ControlClient::~ControlClient() {
+    disconnect();
+}
+
+const std::filesystem::path& ControlClient::getSocketPath() const noexcept {
+    return m_socketPath;
+}
+
+#if defined(__linux__) || defined(__APPLE__)
+void ControlClient::connect() {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+
+    const std::string path = m_socketPath.string();
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error{fmt::format("Control socket path is too long: {}", path)};
+    }
+
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    m_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (m_fd < 0) {
+        throw std::runtime_error{fmt::format("Failed to create socket: {}", std::strerror(errno))};
+    }
+
+    if (::connect(m_fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        const std::string error = std::strerror(errno);
+        disconnect();
+        throw std::runtime_error{fmt::format("Failed to connect to {}: {}", path, error)};
+    }
+}
+
+void ControlClient::disconnect() noexcept {
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+
+    m_pending.clear();
+}
+
+rapidjson::Document ControlClient::request(const std::string_view request, const std::chrono::milliseconds timeout) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+
+    if (m_fd < 0) {
+        connect();
+    }
+
+    if (!sendAll(m_fd, std::string{request} + '\n')) {
+        disconnect();
+        throw std::runtime_error{fmt::format("Lost connection to {}", m_socketPath.string())};
+    }
+
+    std::array<char, 4096> chunk{};
+    std::size_t newline;
+    while ((newline = m_pending.find('\n')) == std::string::npos) {
+        const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now());
+
+        pollfd pfd{m_fd, POLLIN, 0};
+        if (remaining.count() <= 0 || ::poll(&pfd, 1, static_cast<int>(remaining.count())) <= 0) {
+            // A late response would be mistaken for the answer to the next request
+            disconnect();
+            throw ControlTimeout{fmt::format("Timed out waiting for {}", m_socketPath.string())};
+        }
+
+        const ssize_t received = ::recv(m_fd, chunk.data(), chunk.size(), 0);
+        if (received <= 0) {
+            disconnect();
+            throw std::runtime_error{fmt::format("Lost connection to {}", m_socketPath.string())};
+        }
+
+        m_pending.append(chunk.data(), static_cast<std::size_t>(received));
+    }
+
+    const std::string response = m_pending.substr(0, newline);
+    m_pending.erase(0, newline + 1);
+
+    return parseJsonResponse(response);
+}
+#else
+void ControlClient::connect() {
+    throw std::runtime_error{"Control sockets are only supported on Linux and macOS."};
+}
+
+void ControlClient::disconnect() noexcept {}
+
+rapidjson::Document ControlClient::request(std::string_view, std::chrono::milliseconds) {
+    connect();
+    return {};
+}
+#endif
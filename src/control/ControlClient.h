@@ -0,0 +1,45 @@
+#ifndef CONTROLCLIENT_H
+#define CONTROLCLIENT_H
+
+#include <rapidjson/document.h>
+
+#include <chrono>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+// The other instance is still connected but didn't answer in time, e.g. because it's busy or hung
+struct ControlTimeout final : std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+// Sends requests to another DARE instance's control socket. Not thread-safe.
+class ControlClient {
+public:
+    explicit ControlClient(std::filesystem::path socketPath);
+    ~ControlClient();
+
+    ControlClient(const ControlClient&) = delete;
+    ControlClient& operator=(const ControlClient&) = delete;
+    ControlClient(ControlClient&& other) noexcept;
+    ControlClient& operator=(ControlClient&&) = delete;
+
+    // Sends a request line and waits for its response, connecting first if needed.
+    // Throws ControlTimeout if it doesn't answer in time, and std::runtime_error if the socket can't be reached or
+    // the connection is lost. Unsuccessful responses are returned as is.
+    rapidjson::Document request(std::string_view request, std::chrono::milliseconds timeout);
+
+    void disconnect() noexcept;
+
+    [[nodiscard]] const std::filesystem::path& getSocketPath() const noexcept;
+
+private:
+    void connect();
+
+    std::filesystem::path m_socketPath;
+    int m_fd = -1;
+    std::string m_pending;
+};
+
+#endif // CONTROLCLIENT_H
@@ -0,0 +1,45 @@
+#ifndef CONTROLHANDLER_H
+#define CONTROLHANDLER_H
+
+#include "task/TaskMetrics.h"
+
+#include <chrono>
+#include <expected>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct TaskStatus {
+    std::string name;
+    std::string cwid;
+    std::string term;
+    std::string state;
+    bool finished = false;
+    std::chrono::milliseconds uptime{0};
+    std::map<std::string, StageTiming, std::less<>> timings;
+
+    // Only set by a coordinator: the control socket of the worker running the task
+    std::string worker;
+};
+
+// Whatever a ControlServer forwards requests to: a TaskManager running tasks itself, or a Coordinator
+// passing them on to workers.
+class ControlHandler {
+public:
+    virtual ~ControlHandler() = default;
+
+    // Starts a task from in-memory config contents, replacing any existing task with the same name.
+    virtual std::expected<void, std::string> submit(const std::string& name, std::string_view contents) = 0;
+
+    // Stops and removes the task with the given name. Returns false if there is no such task.
+    virtual bool cancel(const std::string& name) = 0;
+
+    virtual std::vector<TaskStatus> getStatus() = 0;
+
+    // Writes the named task's recent debug output to disk and returns the file's path.
+    virtual std::expected<std::string, std::string> dump(const std::string& name) = 0;
+};
+
+#endif // CONTROLHANDLER_H
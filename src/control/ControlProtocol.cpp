@@ -0,0 +1,238 @@
+#include "control/ControlProtocol.h"
+
+#include <fmt/format.h>
+#include <rapidjson/writer.h>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/socket.h>
+#endif
+
+namespace {
+template <typename Writer>
+void writeString(Writer& writer, const std::string_view key, const std::string_view value) {
+    writer.Key(key.data(), static_cast<rapidjson::SizeType>(key.size()));
+    writer.String(value.data(), static_cast<rapidjson::SizeType>(value.size()));
+}
+
+std::string readString(const rapidjson::Value& json, const char* name) {
+    if (!json.HasMember(name) || !json[name].IsString()) {
+        return {};
+    }
+
+    return std::string{json[name].GetString(), json[name].GetStringLength()};
+}
+
+std::chrono::milliseconds readMilliseconds(const rapidjson::Value& json, const char* name) {
+    if (!json.HasMember(name) || !json[name].IsInt64()) {
+        return std::chrono::milliseconds{0};
+    }
+
+    return std::chrono::milliseconds{json[name].GetInt64()};
+}
+
+std::string makeRequest(const std::string_view command, const std::string_view name = {},
+        const std::string_view config = {}) {
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer writer{buffer};
+
+    writer.StartObject();
+    writeString(writer, "command", command);
+    if (!name.empty()) {
+        writeString(writer, "name", name);
+    }
+    if (!config.empty()) {
+        writeString(writer, "config", config);
+    }
+    writer.EndObject();
+
+    return std::string{buffer.GetString(), buffer.GetLength()};
+}
+} // namespace
+
+std::string makeAddRequest(const std::string_view name, const std::string_view config) {
+    return makeRequest("add", name, config);
+}
+
+std::string makeRemoveRequest(const std::string_view name) {
+    return makeRequest("remove", name);
+}
+
+std::string makeStatusRequest() {
+    return makeRequest("status");
+}
+
+std::string makeDumpRequest(const std::string_view name) {
+    return makeRequest("dump", name);
+}
+
+std::string makeResponse(const bool success, const std::string_view error) {
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer writer{buffer};
+
+    writer.StartObject();
+    writer.Key("success");
+    writer.Bool(success);
+    if (!error.empty()) {
+        writeString(writer, "error", error);
+    }
+    writer.EndObject();
+
+    return std::string{buffer.GetString(), buffer.GetLength()};
+}
+
+std::string makeStatusResponse(const std::vector<TaskStatus>& statuses) {
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer writer{buffer};
+
+    writer.StartObject();
+    writer.Key("success");
+    writer.Bool(true);
+    writer.Key("tasks");
+    writer.StartArray();
+
+    for (const TaskStatus& status : statuses) {
+        writer.StartObject();
+        writeString(writer, "name", status.name);
+        writeString(writer, "cwid", status.cwid);
+        writeString(writer, "term", status.term);
+        writeString(writer, "state", status.state);
+        if (!status.worker.empty()) {
+            writeString(writer, "worker", status.worker);
+        }
+        writer.Key("finished");
+        writer.Bool(status.finished);
+        writer.Key("uptimeMs");
+        writer.Int64(status.uptime.count());
+
+        writer.Key("timings");
+        writer.StartObject();
+        for (const auto& [stage, timing] : status.timings) {
+            writer.Key(stage.c_str(), static_cast<rapidjson::SizeType>(stage.size()));
+            writer.StartObject();
+            writer.Key("lastMs");
+            writer.Int64(timing.last.count());
+            writer.Key("totalMs");
+            writer.Int64(timing.total.count());
+            writer.Key("count");
+            writer.Uint64(timing.count);
+            writer.EndObject();
+        }
+        writer.EndObject();
+
+        writer.EndObject();
+    }
+
+    writer.EndArray();
+    writer.EndObject();
+
+    return std::string{buffer.GetString(), buffer.GetLength()};
+}
+
+std::string makeDumpResponse(const std::string_view path) {
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer writer{buffer};
+
+    writer.StartObject();
+    writer.Key("success");
+    writer.Bool(true);
+    writeString(writer, "path", path);
+    writer.EndObject();
+
+    return std::string{buffer.GetString(), buffer.GetLength()};
+}
+
+std::optional<std::string> getResponseError(const rapidjson::Document& response) {
+    if (!response.IsObject() || !response.HasMember("success") || !response["success"].IsBool()) {
+        return "Malformed response.";
+    }
+
+    if (response["success"].GetBool()) {
+        return std::nullopt;
+    }
+
+    std::string error = readString(response, "error");
+    return error.empty() ? "Unknown error." : error;
+}
+
+std::vector<TaskStatus> parseStatusResponse(const rapidjson::Document& response) {
+    if (const auto error = getResponseError(response)) {
+        throw std::runtime_error{*error};
+    }
+
+    if (!response.HasMember("tasks") || !response["tasks"].IsArray()) {
+        throw std::runtime_error{"Status response is missing its tasks."};
+    }
+
+    std::vector<TaskStatus> statuses;
+    statuses.reserve(response["tasks"].Size());
+
+    for (const auto& task : response["tasks"].GetArray()) {
+        if (!task.IsObject()) {
+            continue;
+        }
+
+        TaskStatus status{
+            .name = readString(task, "name"),
+            .cwid = readString(task, "cwid"),
+            .term = readString(task, "term"),
+            .state = readString(task, "state"),
+            .finished = task.HasMember("finished") && task["finished"].IsBool() && task["finished"].GetBool(),
+            .uptime = readMilliseconds(task, "uptimeMs"),
+            .timings = {},
+            .worker = readString(task, "worker")
+        };
+
+        if (task.HasMember("timings") && task["timings"].IsObject()) {
+            for (const auto& [stage, timing] : task["timings"].GetObject()) {
+                if (!timing.IsObject()) {
+                    continue;
+                }
+
+                status.timings.emplace(std::string{stage.GetString(), stage.GetStringLength()}, StageTiming{
+                    .last = readMilliseconds(timing, "lastMs"),
+                    .total = readMilliseconds(timing, "totalMs"),
+                    .count = timing.HasMember("count") && timing["count"].IsUint64()
+                        ? static_cast<std::size_t>(timing["count"].GetUint64()) : 0
+                });
+            }
+        }
+
+        statuses.push_back(std::move(status));
+    }
+
+    return statuses;
+}
+
+std::string parseDumpResponse(const rapidjson::Document& response) {
+    if (const auto error = getResponseError(response)) {
+        throw std::runtime_error{*error};
+    }
+
+    std::string path = readString(response, "path");
+    if (path.empty()) {
+        throw std::runtime_error{"Dump response is missing its path."};
+    }
+
+    return path;
+}
+
+#if defined(__linux__) || defined(__APPLE__)
+bool sendAll(const int fd, std::string_view data) {
+#if defined(MSG_NOSIGNAL)
+    static constexpr int FLAGS = MSG_NOSIGNAL;
+#else
+    static constexpr int FLAGS = 0;
+#endif
+
+    while (!data.empty()) {
+        const ssize_t sent = ::send(fd, data.data(), data.size(), FLAGS);
+        if (sent <= 0) {
+            return false;
+        }
+
+        data.remove_prefix(static_cast<std::size_t>(sent));
+    }
+
+    return true;
+}
+#endif
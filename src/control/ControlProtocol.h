@@ -0,0 +1,36 @@
+#ifndef CONTROLPROTOCOL_H
+#define CONTROLPROTOCOL_H
+
+#include "control/ControlHandler.h"
+
+#include <rapidjson/document.h>
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Messages exchanged over a control socket. Each request and response is a single line of JSON.
+
+std::string makeAddRequest(std::string_view name, std::string_view config);
+std::string makeRemoveRequest(std::string_view name);
+std::string makeStatusRequest();
+std::string makeDumpRequest(std::string_view name);
+
+std::string makeResponse(bool success, std::string_view error = {});
+std::string makeStatusResponse(const std::vector<TaskStatus>& statuses);
+std::string makeDumpResponse(std::string_view path);
+
+// Returns the error of an unsuccessful response, or std::nullopt if it succeeded.
+std::optional<std::string> getResponseError(const rapidjson::Document& response);
+
+// Throws if the response is malformed or unsuccessful.
+std::vector<TaskStatus> parseStatusResponse(const rapidjson::Document& response);
+std::string parseDumpResponse(const rapidjson::Document& response);
+
+#if defined(__linux__) || defined(__APPLE__)
+// Sends everything or returns false if the peer went away.
+bool sendAll(int fd, std::string_view data);
+#endif
+
+#endif // CONTROLPROTOCOL_H
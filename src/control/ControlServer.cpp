@@ -0,0 +1,225 @@
+#include "control/ControlServer.h"
+#include "control/ControlHandler.h"
+#include "control/ControlProtocol.h"
+#include "util/Utility.h"
+
+#include <fmt/format.h>
+#include <rapidjson/document.h>
+#include <spdlog/spdlog.h>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include <array>
+#include <cstring>
+
+namespace {
+constexpr int POLL_TIMEOUT_MS = 250;
+constexpr std::size_t MAX_REQUEST_SIZE = 1024 * 1024;
+
+std::string getStringMember(const rapidjson::Document& json, const char* name) {
+    if (!json.HasMember(name) || !json[name].IsString()) {
+        throw std::runtime_error{fmt::format("Missing string member '{}'.", name)};
+    }
+
+    return std::string{json[name].GetString(), json[name].GetStringLength()};
+}
+} // namespace
+
+ControlServer::ControlServer(ControlHandler& handler, std::filesystem::path socketPath)
+    : m_handler{handler}, m_socketPath{std::move(socketPath)} {}
+
+ControlServer::~ControlServer() {
+    stop();
+
+    if (m_acceptFuture.valid()) {
+        m_acceptFuture.wait();
+    }
+
+    std::lock_guard lock{m_connectionsMutex};
+    for (auto& connection : m_connections) {
+        connection.wait();
+    }
+}
+
+#if defined(__linux__) || defined(__APPLE__)
+void ControlServer::start() {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+
+    const std::string path = m_socketPath.string();
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error{fmt::format("Control socket path is too long: {}", path)};
+    }
+
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    m_listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (m_listenFd < 0) {
+        throw std::runtime_error{fmt::format("Failed to create control socket: {}", std::strerror(errno))};
+    }
+
+    // A stale socket file from a previous run would make bind() fail
+    std::error_code ec;
+    std::filesystem::remove(m_socketPath, ec);
+
+    // The socket accepts plaintext passwords, so only the owner should be able to connect. The umask makes bind()
+    // create it that way, since a chmod() afterwards would leave a window where anyone could.
+    const mode_t previousUmask = ::umask(S_IRWXG | S_IRWXO);
+    const bool bound = ::bind(m_listenFd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+    const int bindErrno = errno;
+    ::umask(previousUmask);
+
+    if (!bound || ::listen(m_listenFd, SOMAXCONN) != 0) {
+        const std::string error = std::strerror(bound ? errno : bindErrno);
+        ::close(m_listenFd);
+        m_listenFd = -1;
+        throw std::runtime_error{fmt::format("Failed to listen on control socket {}: {}", path, error)};
+    }
+
+    m_acceptFuture = std::async(std::launch::async, [this] {
+        acceptLoop();
+    });
+
+    spdlog::get("console")->info("Listening for control requests on {}", path);
+}
+
+void ControlServer::acceptLoop() {
+    while (!m_stopRequested.load()) {
+        pollfd pfd{m_listenFd, POLLIN, 0};
+        if (::poll(&pfd, 1, POLL_TIMEOUT_MS) <= 0 || !(pfd.revents & POLLIN)) {
+            reapConnections();
+            continue;
+        }
+
+        const int clientFd = ::accept(m_listenFd, nullptr, nullptr);
+        if (clientFd < 0) {
+            continue;
+        }
+
+        std::lock_guard lock{m_connectionsMutex};
+        m_connections.emplace_back(std::async(std::launch::async, [this, clientFd] {
+            serveConnection(clientFd);
+            ::close(clientFd);
+        }));
+    }
+
+    ::close(m_listenFd);
+    m_listenFd = -1;
+
+    std::error_code ec;
+    std::filesystem::remove(m_socketPath, ec);
+}
+
+void ControlServer::serveConnection(const int fd) {
+    std::string pending;
+    std::array<char, 4096> chunk{};
+
+    while (!m_stopRequested.load()) {
+        pollfd pfd{fd, POLLIN, 0};
+        if (const int ready = ::poll(&pfd, 1, POLL_TIMEOUT_MS); ready == 0) {
+            continue;
+        } else if (ready < 0) {
+            return;
+        }
+
+        const ssize_t received = ::recv(fd, chunk.data(), chunk.size(), 0);
+        if (received <= 0) {
+            return;
+        }
+
+        pending.append(chunk.data(), static_cast<std::size_t>(received));
+
+        std::size_t newline;
+        while ((newline = pending.find('\n')) != std::string::npos) {
+            std::string response = handleRequest(std::string_view{pending}.substr(0, newline));
+            response += '\n';
+            pending.erase(0, newline + 1);
+
+            if (!sendAll(fd, response)) {
+                return;
+            }
+        }
+
+        if (pending.size() > MAX_REQUEST_SIZE) {
+            sendAll(fd, makeResponse(false, "Request too large.") + '\n');
+            return;
+        }
+    }
+}
+#else
+void ControlServer::start() {
+    throw std::runtime_error{"The control socket is only supported on Linux and macOS."};
+}
+
+void ControlServer::acceptLoop() {}
+
+void ControlServer::serveConnection(int) {}
+#endif
+
+void ControlServer::stop() noexcept {
+    m_stopRequested.store(true);
+}
+
+const std::filesystem::path& ControlServer::getSocketPath() const noexcept {
+    return m_socketPath;
+}
+
+void ControlServer::reapConnections() {
+    static constexpr std::chrono::seconds WAIT_TIME{0};
+
+    std::lock_guard lock{m_connectionsMutex};
+    std::erase_if(m_connections, [](const std::future<void>& connection) {
+        return connection.wait_for(WAIT_TIME) == std::future_status::ready;
+    });
+}
+
+std::string ControlServer::handleRequest(const std::string_view request) {
+    try {
+        const rapidjson::Document json = parseJsonResponse(trimSurroundingChars(request));
+        if (!json.IsObject()) {
+            return makeResponse(false, "Request must be a JSON object.");
+        }
+
+        const std::string command = getStringMember(json, "command");
+
+        if (command == "add") {
+            const std::string name = getStringMember(json, "name");
+            if (const auto result = m_handler.submit(name, getStringMember(json, "config")); !result) {
+                return makeResponse(false, result.error());
+            }
+
+            return makeResponse(true);
+        }
+
+        if (command == "remove") {
+            if (!m_handler.cancel(getStringMember(json, "name"))) {
+                return makeResponse(false, "No task with that name.");
+            }
+
+            return makeResponse(true);
+        }
+
+        if (command == "status") {
+            return makeStatusResponse(m_handler.getStatus());
+        }
+
+        if (command == "dump") {
+            const auto path = m_handler.dump(getStringMember(json, "name"));
+            if (!path) {
+                return makeResponse(false, path.error());
+            }
+
+            return makeDumpResponse(*path);
+        }
+
+        return makeResponse(false, fmt::format("Unknown command '{}'.", command));
+    } catch (const std::exception& e) {
+        return makeResponse(false, e.what());
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef CONTROLSERVER_H
+#define CONTROLSERVER_H
+
+#include <atomic>
+#include <filesystem>
+#include <future>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class ControlHandler;
+
+// Serves newline-delimited JSON requests over a Unix domain socket so that tasks can be
+// submitted, cancelled, and inspected directly instead of going through the configs directory.
+// See ControlProtocol.h for building and parsing the messages.
+//
+// Requests:
+//   {"command": "add", "name": "<name>", "config": "<TOML config contents>"}
+//   {"command": "remove", "name": "<name>"}
+//   {"command": "status"}
+//   {"command": "dump", "name": "<name>"}
+//
+// Every response is a single JSON line with a "success" member, plus "error" on failure.
+class ControlServer {
+public:
+    ControlServer(ControlHandler& handler, std::filesystem::path socketPath);
+    ~ControlServer();
+
+    ControlServer(const ControlServer&) = delete;
+    ControlServer& operator=(const ControlServer&) = delete;
+
+    void start();
+    void stop() noexcept;
+
+    [[nodiscard]] const std::filesystem::path& getSocketPath() const noexcept;
+
+private:
+    void acceptLoop();
+    void serveConnection(int fd);
+    void reapConnections();
+    std::string handleRequest(std::string_view request);
+
+    ControlHandler& m_handler;
+    std::filesystem::path m_socketPath;
+    int m_listenFd = -1;
+
+    std::atomic<bool> m_stopRequested{false};
+    std::future<void> m_acceptFuture;
+    std::mutex m_connectionsMutex;
+    std::vector<std::future<void>> m_connections;
+};
+
+#endif // CONTROLSERVER_H
@@ -0,0 +1,424 @@
+#include "control/Coordinator.h"
+#include "control/ControlProtocol.h"
+#include "task/ConfigLoader.h"
+
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <fstream>
+#include <ranges>
+#include <set>
+#include <sstream>
+
+namespace {
+std::string readFile(const std::filesystem::path& path) {
+    std::ifstream file{path, std::ios::binary};
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+} // namespace
+
+Coordinator::Coordinator(const std::vector<std::filesystem::path>& workerSockets) {
+    if (workerSockets.empty()) {
+        throw std::runtime_error{"A coordinator needs at least one worker."};
+    }
+
+    m_workers.reserve(workerSockets.size());
+    for (const auto& socketPath : workerSockets) {
+        m_workers.push_back(Worker{.id = socketPath.string(), .client = ControlClient{socketPath}});
+    }
+}
+
+Coordinator::~Coordinator() {
+    stop();
+}
+
+void Coordinator::enableControlSocket(std::filesystem::path socketPath) {
+    m_controlServer = std::make_unique<ControlServer>(*this, std::move(socketPath));
+}
+
+void Coordinator::start() {
+    const auto console = spdlog::get("console");
+
+    if (m_controlServer) {
+        try {
+            m_controlServer->start();
+        } catch (const std::exception& e) {
+            console->error("Failed to start control socket: {}", e.what());
+            m_controlServer.reset();
+        }
+    }
+
+    loadConfigsFrom(m_configDirectory, false);
+    loadConfigsFrom(m_submittedDirectory, true);
+
+    if (std::lock_guard lock{m_mutex}; m_tasks.empty() && !m_controlServer) {
+        console->info("Please set up at least one valid configuration file in the 'configs' directory.");
+        return;
+    }
+
+    console->info("Coordinating {} worker{}.", m_workers.size(), determinePlural(m_workers.size()));
+
+    while (!m_shutdownRequested.load()) {
+        reconcile();
+
+        std::unique_lock lock{m_mutex};
+        m_wakeCv.wait_for(lock, RECONCILE_INTERVAL, [&] {
+            return m_shutdownRequested.load() || m_reconcileRequested.load();
+        });
+        m_reconcileRequested.store(false);
+    }
+
+    // Workers keep running their tasks so that restarting the coordinator doesn't interrupt anything
+    console->info("Shutting down.");
+}
+
+void Coordinator::stop() {
+    if (m_controlServer) {
+        m_controlServer->stop();
+    }
+
+    m_shutdownRequested.store(true);
+    m_wakeCv.notify_all();
+}
+
+std::expected<void, std::string> Coordinator::submit(const std::string& name, const std::string_view contents) {
+    // The name doubles as the file name of the saved config
+    if (name.empty() || sanitizeFileName(name) != name) {
+        return std::unexpected{"Task names may only contain letters, digits, '-', '_', and '.'."};
+    }
+
+    // Workers validate the rest when they receive it
+    std::string cwid;
+    try {
+        cwid = ConfigLoader::readCwid(contents);
+    } catch (const std::exception& e) {
+        return std::unexpected{fmt::format("Error reading config for {}: {}", name, e.what())};
+    }
+
+    try {
+        // Configs contain passwords
+        std::filesystem::create_directories(m_submittedDirectory);
+        writePrivateFile(m_submittedDirectory / (name + ".txt"), contents);
+    } catch (const std::exception& e) {
+        return std::unexpected{fmt::format("Failed to save config for {}: {}", name, e.what())};
+    }
+
+    {
+        std::lock_guard lock{m_mutex};
+        ShardedTask& task = m_tasks[name];
+        task.cwid = std::move(cwid);
+        task.contents = std::string{contents};
+        task.finished = false;
+        task.resubmit = true;
+        task.lastStatus.reset();
+    }
+
+    spdlog::get("console")->info("Task submitted through control socket: {}", name);
+    m_reconcileRequested.store(true);
+    m_wakeCv.notify_all();
+
+    return {};
+}
+
+bool Coordinator::cancel(const std::string& name) {
+    bool erased;
+    {
+        std::lock_guard lock{m_mutex};
+        erased = m_tasks.erase(name) > 0;
+    }
+
+    std::error_code ec;
+    std::filesystem::remove(m_submittedDirectory / (name + ".txt"), ec);
+
+    // The next reconcile removes it from whichever worker is running it
+    m_reconcileRequested.store(true);
+    m_wakeCv.notify_all();
+
+    return erased;
+}
+
+std::vector<TaskStatus> Coordinator::getStatus() {
+    std::vector<TaskStatus> statuses;
+
+    std::lock_guard lock{m_mutex};
+    statuses.reserve(m_tasks.size());
+
+    for (const auto& [name, task] : m_tasks) {
+        if (task.lastStatus) {
+            statuses.push_back(*task.lastStatus);
+            continue;
+        }
+
+        statuses.push_back(TaskStatus{
+            .name = name,
+            .cwid = task.cwid,
+            .state = task.worker.empty() ? "Waiting for a worker" : "Submitting to worker",
+            .worker = task.worker
+        });
+    }
+
+    return statuses;
+}
+
+std::expected<std::string, std::string> Coordinator::dump(const std::string& name) {
+    std::string worker;
+    {
+        std::lock_guard lock{m_mutex};
+        const auto it = m_tasks.find(name);
+        if (it == m_tasks.end()) {
+            return std::unexpected{"No task with that name."};
+        }
+
+        worker = it->second.worker;
+    }
+
+    if (worker.empty()) {
+        return std::unexpected{"Task isn't running on a worker yet."};
+    }
+
+    // The workers' clients belong to the reconcile thread
+    try {
+        ControlClient client{worker};
+        return parseDumpResponse(client.request(makeDumpRequest(name), STATUS_TIMEOUT));
+    } catch (const std::exception& e) {
+        return std::unexpected{fmt::format("Worker {}: {}", worker, e.what())};
+    }
+}
+
+void Coordinator::loadConfigsFrom(const std::filesystem::path& directory, const bool submitted) {
+    if (!std::filesystem::is_directory(directory)) {
+        return;
+    }
+
+    const auto console = spdlog::get("console");
+    for (const auto& entry : std::filesystem::directory_iterator{directory}) {
+        if (entry.path().extension() != ".txt") {
+            continue;
+        }
+
+        // Same naming as TaskManager so that a worker's task names line up with ours
+        const std::string name = submitted ? entry.path().stem().string() : entry.path().filename().string();
+
+        try {
+            std::string contents = readFile(entry.path());
+            std::string cwid = ConfigLoader::readCwid(contents);
+
+            std::lock_guard lock{m_mutex};
+            m_tasks[name] = ShardedTask{.cwid = std::move(cwid), .contents = std::move(contents)};
+        } catch (const std::exception& e) {
+            console->error("Error reading config {}: {}", entry.path().filename().string(), e.what());
+        }
+    }
+}
+
+Coordinator::Worker* Coordinator::findWorker(const std::string_view id) {
+    const auto it = std::ranges::find(m_workers, id, &Worker::id);
+    return it == m_workers.end() ? nullptr : &*it;
+}
+
+void Coordinator::pollWorkers() {
+    const auto console = spdlog::get("console");
+
+    for (Worker& worker : m_workers) {
+        const bool wasAlive = worker.alive;
+        worker.answered = false;
+
+        try {
+            worker.tasks = parseStatusResponse(worker.client.request(makeStatusRequest(), STATUS_TIMEOUT));
+            worker.alive = true;
+            worker.reachable = true;
+            worker.answered = true;
+            worker.missedHeartbeats = 0;
+        } catch (const ControlTimeout& e) {
+            // Most likely just busy, and it could still be running its tasks either way
+            worker.reachable = true;
+            if (++worker.missedHeartbeats >= MAX_MISSED_HEARTBEATS && wasAlive) {
+                worker.alive = false;
+                console->error("Worker {} missed {} heartbeats ({}). Moving its tasks once it stops them.",
+                    worker.id, worker.missedHeartbeats, e.what());
+            }
+        } catch (const std::exception& e) {
+            // The socket goes away with the process, so nothing is running there anymore
+            worker.tasks.clear();
+            worker.alive = false;
+            worker.reachable = false;
+
+            if (wasAlive) {
+                console->error("Lost connection to worker {} ({}). Moving its tasks.", worker.id, e.what());
+            }
+        }
+
+        if (worker.alive && !wasAlive) {
+            console->info("Worker {} is available.", worker.id);
+            m_ring.addNode(worker.id);
+        } else if (!worker.alive && wasAlive) {
+            m_ring.removeNode(worker.id);
+        }
+    }
+}
+
+void Coordinator::reconcile() {
+    pollWorkers();
+
+    struct Change {
+        Worker* worker;
+        std::string name;
+        std::string contents;
+    };
+
+    std::vector<Change> removals;
+    std::vector<Change> additions;
+
+    {
+        std::lock_guard lock{m_mutex};
+
+        for (auto& [name, task] : m_tasks) {
+            const std::optional<std::string> owner = m_ring.getNode(task.cwid);
+            task.worker = owner.value_or("");
+        }
+
+        for (Worker& worker : m_workers) {
+            if (!worker.reachable) {
+                for (ShardedTask& task : m_tasks | std::views::values) {
+                    task.placements.erase(worker.id);
+                }
+                continue;
+            }
+
+            if (!worker.answered) {
+                continue;
+            }
+
+            // Whatever it doesn't list isn't running there
+            for (auto& [name, task] : m_tasks) {
+                if (std::ranges::find(worker.tasks, name, &TaskStatus::name) == worker.tasks.end()) {
+                    task.placements.erase(worker.id);
+                }
+            }
+
+            // Pick up what it reports and drop anything it shouldn't be running anymore
+            for (TaskStatus& status : worker.tasks) {
+                const auto it = m_tasks.find(status.name);
+                if (it == m_tasks.end()) {
+                    removals.push_back(Change{&worker, status.name, {}});
+                    continue;
+                }
+
+                ShardedTask& task = it->second;
+                task.placements.insert(worker.id);
+                if (task.worker != worker.id) {
+                    removals.push_back(Change{&worker, status.name, {}});
+                    continue;
+                }
+
+                status.worker = worker.id;
+                task.finished = task.finished || (status.finished && !task.resubmit);
+                task.lastStatus = status;
+
+                // Its result is kept here, so the worker can let go of it
+                if (task.finished && status.finished) {
+                    removals.push_back(Change{&worker, status.name, {}});
+                }
+            }
+        }
+
+        // A finished task stays finished even if its worker goes away, so that it isn't registered twice
+        for (const auto& [name, task] : m_tasks) {
+            Worker* owner = findWorker(task.worker);
+            if (owner == nullptr || task.finished) {
+                continue;
+            }
+
+            // Anywhere else it might be running has to stop it first. Answering workers were asked to above.
+            bool runningElsewhere = false;
+            for (const std::string& placement : task.placements) {
+                if (placement == owner->id) {
+                    continue;
+                }
+
+                runningElsewhere = true;
+                if (Worker* previous = findWorker(placement); previous != nullptr && !previous->answered) {
+                    removals.push_back(Change{previous, name, {}});
+                }
+            }
+
+            if (!runningElsewhere && (!task.placements.contains(owner->id) || task.resubmit)) {
+                additions.push_back(Change{owner, name, task.contents});
+            }
+        }
+    }
+
+    const auto console = spdlog::get("console");
+    std::set<const Worker*> timedOut;
+    for (const auto& [worker, name, contents] : removals) {
+        // A busy worker only gets one try per round, so that it can't hold up the rest for long
+        if (timedOut.contains(worker)) {
+            continue;
+        }
+
+        try {
+            if (const auto error = getResponseError(worker->client.request(makeRemoveRequest(name), SUBMIT_TIMEOUT))) {
+                console->warn("Worker {} could not remove {}: {}", worker->id, name, *error);
+            }
+        } catch (const ControlTimeout& e) {
+            console->warn("Worker {} didn't confirm removing {}: {}", worker->id, name, e.what());
+            timedOut.insert(worker);
+            continue;
+        } catch (const std::exception& e) {
+            console->warn("Failed to remove {} from worker {}: {}", name, worker->id, e.what());
+        }
+
+        // Either it answered, which it only does once the task has stopped, or its process is gone
+        std::lock_guard lock{m_mutex};
+        if (const auto it = m_tasks.find(name); it != m_tasks.end()) {
+            it->second.placements.erase(worker->id);
+        }
+    }
+
+    for (const auto& [worker, name, contents] : additions) {
+        std::optional<std::string> error;
+        try {
+            error = getResponseError(worker->client.request(makeAddRequest(name, contents), SUBMIT_TIMEOUT));
+        } catch (const ControlTimeout& e) {
+            console->warn("Worker {} didn't confirm submitting {}: {}", worker->id, name, e.what());
+
+            // It might have started the task anyway, so it has to confirm otherwise before the task goes elsewhere
+            std::lock_guard lock{m_mutex};
+            if (const auto it = m_tasks.find(name); it != m_tasks.end()) {
+                it->second.placements.insert(worker->id);
+            }
+            continue;
+        } catch (const std::exception& e) {
+            // Most likely the worker died. The next poll notices and moves the task elsewhere.
+            console->warn("Failed to submit {} to worker {}: {}", name, worker->id, e.what());
+            continue;
+        }
+
+        std::lock_guard lock{m_mutex};
+        const auto it = m_tasks.find(name);
+        if (it == m_tasks.end() || it->second.contents != contents) {
+            continue;
+        }
+
+        it->second.resubmit = false;
+
+        if (error) {
+            // The worker rejected the config itself, so retrying elsewhere won't help
+            console->error("Worker {} rejected {}: {}", worker->id, name, *error);
+            it->second.finished = true;
+            it->second.lastStatus = TaskStatus{
+                .name = name,
+                .cwid = it->second.cwid,
+                .state = "Rejected: " + *error,
+                .finished = true,
+                .worker = worker->id
+            };
+        } else {
+            it->second.placements.insert(worker->id);
+            console->info("Assigned {} to worker {}.", name, worker->id);
+        }
+    }
+}
@@ -0,0 +1,102 @@
+#ifndef COORDINATOR_H
+#define COORDINATOR_H
+
+#include "control/ControlClient.h"
+#include "control/ControlHandler.h"
+#include "control/ControlServer.h"
+#include "control/HashRing.h"
+#include "util/Utility.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+// Shards tasks across worker DARE processes (started with `--worker --control-socket <path>`) by consistent
+// hashing on CWID, so every task for the same student lands on the same worker.
+//
+// Every RECONCILE_INTERVAL the coordinator asks each worker for its status. A worker is taken off the ring once its
+// connection is lost or it misses MAX_MISSED_HEARTBEATS status requests in a row, and its unfinished tasks move to
+// whichever workers now own them. When it comes back, only the tasks that hash to it move back.
+//
+// A task is never submitted to its new worker while it might still be running on another: the old worker has to
+// answer a request to remove it first (which only returns once the task has stopped), or its process has to be gone.
+class Coordinator final : public ControlHandler {
+public:
+    explicit Coordinator(const std::vector<std::filesystem::path>& workerSockets);
+    ~Coordinator() override;
+
+    Coordinator(const Coordinator&) = delete;
+    Coordinator& operator=(const Coordinator&) = delete;
+
+    // Must be called before start().
+    void enableControlSocket(std::filesystem::path socketPath);
+
+    // Distributes the configs in the configs directory and keeps them balanced until stop() is called.
+    void start();
+    void stop();
+
+    std::expected<void, std::string> submit(const std::string& name, std::string_view contents) override;
+    bool cancel(const std::string& name) override;
+    std::vector<TaskStatus> getStatus() override;
+    std::expected<std::string, std::string> dump(const std::string& name) override;
+
+private:
+    struct Worker {
+        std::string id;
+        ControlClient client;
+        bool alive = false; // On the ring
+        bool reachable = false; // Still connected, even if it isn't answering
+        bool answered = false; // In the last poll, so `tasks` is current
+        int missedHeartbeats = 0;
+        std::vector<TaskStatus> tasks;
+    };
+
+    struct ShardedTask {
+        std::string cwid;
+        std::string contents;
+        std::string worker;
+        bool finished = false;
+
+        // Set when the contents changed, so that the owning worker gets them even if it's already running the task
+        bool resubmit = false;
+        std::optional<TaskStatus> lastStatus;
+
+        // Workers that might be running it, until they confirm they aren't
+        std::set<std::string, std::less<>> placements;
+    };
+
+    void loadConfigsFrom(const std::filesystem::path& directory, bool submitted);
+    void reconcile();
+    void pollWorkers();
+    Worker* findWorker(std::string_view id);
+
+    static constexpr std::chrono::seconds RECONCILE_INTERVAL{2};
+    static constexpr std::chrono::seconds STATUS_TIMEOUT{2};
+    static constexpr int MAX_MISSED_HEARTBEATS = 5;
+    static constexpr std::chrono::seconds SUBMIT_TIMEOUT{30};
+
+    // Only touched by the thread running start()
+    std::vector<Worker> m_workers;
+    HashRing m_ring;
+
+    std::mutex m_mutex;
+    std::map<std::string, ShardedTask, std::less<>> m_tasks;
+
+    std::atomic<bool> m_shutdownRequested{false};
+    std::atomic<bool> m_reconcileRequested{false};
+    std::condition_variable m_wakeCv;
+    std::unique_ptr<ControlServer> m_controlServer;
+
+    const std::filesystem::path m_configDirectory = getExecutableDirectory() + "/configs";
+    const std::filesystem::path m_submittedDirectory = getStateDirectory() / "submitted";
+};
+
+#endif // COORDINATOR_H
@@ -0,0 +1,44 @@
+#include "control/HashRing.h"
+#include "util/Utility.h"
+
+#include <fmt/format.h>
+
+namespace {
+std::uint64_t hashKey(const std::string_view key) {
+    // FNV-1a alone clusters similar keys like "a.sock#1" and "a.sock#2", so finish with a SplitMix64 mix
+    std::uint64_t hash = fnv1a(key);
+    hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBULL;
+    return hash ^ (hash >> 31);
+}
+} // namespace
+
+void HashRing::addNode(const std::string& node) {
+    for (int i = 0; i < VIRTUAL_NODES; ++i) {
+        m_points.emplace(hashKey(fmt::format("{}#{}", node, i)), node);
+    }
+}
+
+void HashRing::removeNode(const std::string_view node) {
+    std::erase_if(m_points, [&](const auto& point) {
+        return point.second == node;
+    });
+}
+
+std::optional<std::string> HashRing::getNode(const std::string_view key) const {
+    if (m_points.empty()) {
+        return std::nullopt;
+    }
+
+    // The first point clockwise from the key owns it, wrapping around past the end
+    auto it = m_points.lower_bound(hashKey(key));
+    if (it == m_points.end()) {
+        it = m_points.begin();
+    }
+
+    return it->second;
+}
+
+bool HashRing::empty() const noexcept {
+    return m_points.empty();
+}
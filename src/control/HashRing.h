@@ -0,0 +1,26 @@
+#ifndef HASHRING_H
+#define HASHRING_H
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// Consistent hash ring. Each node is placed at VIRTUAL_NODES points so that keys spread evenly
+// and adding or removing a node only moves the keys that hash to it.
+class HashRing {
+public:
+    void addNode(const std::string& node);
+    void removeNode(std::string_view node);
+
+    [[nodiscard]] std::optional<std::string> getNode(std::string_view key) const;
+    [[nodiscard]] bool empty() const noexcept;
+
+private:
+    static constexpr int VIRTUAL_NODES = 128;
+
+    std::map<std::uint64_t, std::string> m_points;
+};
+
+#endif // HASHRING_H
@@ -75,22 +75,7 @@ std::vector<int> getClassEnrollmentInfo(const std::string& termCode, const std::
 } // namespace
 
 std::string EnrollmentInfo::getDescription() const {
-    switch (status) {
-        using enum CourseStatus;
-        using enum SeatType;
-
-        case Open:
-            return fmt::format("Open - Seats Available: {}", seats[+EnrollmentSeatsAvailable]);
-        case WaitlistOpen:
-            return fmt::format("Waitlist - Seats Available: {}", seats[+WaitlistSeatsAvailable]);
-        case WaitlistSoon:
-            return fmt::format("Waitlist - Seats Opening Soon: {}",
-                seats[+EnrollmentSeatsAvailable] + seats[+WaitlistSeatsAvailable]);
-        case Closed:
-            return std::string{"Closed - No Seats Available"};
-    }
-
-    std::unreachable();
+    return fmt::format("{}", *this);
 }
 
 EnrollmentInfo checkEnrollmentAvailability(const std::string& termCode, const std::string& crn) {
@@ -1,6 +1,8 @@
 #ifndef ENROLLMENT_H
 #define ENROLLMENT_H
 
+#include <fmt/format.h>
+
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -38,6 +40,32 @@ struct EnrollmentInfo {
 
     // Gets a printable description of the enrollment status and seats available (if any).
     [[nodiscard]] std::string getDescription() const;
+
+    bool operator==(const EnrollmentInfo&) const = default;
+};
+
+// Writes the same text as getDescription() straight into the output
+template <>
+struct fmt::formatter<EnrollmentInfo> : formatter<std::string_view> {
+    auto format(const EnrollmentInfo& info, format_context& ctx) const {
+        switch (info.status) {
+            using enum CourseStatus;
+            using enum SeatType;
+
+            case Open:
+                return fmt::format_to(ctx.out(), "Open - Seats Available: {}", info.seats[+EnrollmentSeatsAvailable]);
+            case WaitlistOpen:
+                return fmt::format_to(ctx.out(), "Waitlist - Seats Available: {}",
+                    info.seats[+WaitlistSeatsAvailable]);
+            case WaitlistSoon:
+                return fmt::format_to(ctx.out(), "Waitlist - Seats Opening Soon: {}",
+                    info.seats[+EnrollmentSeatsAvailable] + info.seats[+WaitlistSeatsAvailable]);
+            case Closed:
+                return formatter<std::string_view>::format("Closed - No Seats Available", ctx);
+        }
+
+        std::unreachable();
+    }
 };
 
 // Checks the enrollment availability for a given term and CRN.
@@ -27,6 +27,8 @@ inline constexpr std::string_view CLASS_REG = "https://reg.oci.fhda.edu/StudentR
 namespace Classes {
 inline constexpr std::string_view SECTION_DETAILS = "https://reg.oci.fhda.edu/StudentRegistrationSsb/ssb/classRegistration/getSectionDetailsFromCRN";
 inline constexpr std::string_view ENROLLMENT_INFO = "https://reg.oci.fhda.edu/StudentRegistrationSsb/ssb/searchResults/getEnrollmentInfo";
+inline constexpr std::string_view TERM_SEARCH = "https://reg.oci.fhda.edu/StudentRegistrationSsb/ssb/term/search?mode=search";
+inline constexpr std::string_view SEARCH_RESULTS = "https://reg.oci.fhda.edu/StudentRegistrationSsb/ssb/searchResults/searchResults";
 } // namespace Classes
 
 namespace Terms {
@@ -0,0 +1,175 @@
+#include "data/SeatHistory.h"
+#include "util/Utility.h"
+
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <limits>
+#include <optional>
+
+namespace {
+constexpr std::array<char, 8> SEAT_HISTORY_MAGIC{'D', 'A', 'R', 'E', 'S', 'E', 'A', 'T'};
+constexpr std::uint32_t SEAT_HISTORY_VERSION = 1;
+
+std::int64_t toMilliseconds(const std::chrono::system_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count();
+}
+
+std::filesystem::path getRingPath(const std::string_view termCode, const std::string_view crn) {
+    return getStateDirectory() / "seats" / fmt::format("{}_{}.bin", sanitizeFileName(termCode), sanitizeFileName(crn));
+}
+} // namespace
+
+SeatHistory::Ring::Ring(const std::filesystem::path& path)
+    : file{path, sizeof(Header) + CAPACITY * sizeof(Record)},
+      header{reinterpret_cast<Header*>(file.getWritableData().data())},
+      records{reinterpret_cast<Record*>(file.getWritableData().data() + sizeof(Header))} {
+    static_assert(sizeof(Record) == 24 && sizeof(Header) == 32);
+
+    // A new file is all zeroes. One from another version or with another capacity starts over.
+    if (header->magic != SEAT_HISTORY_MAGIC || header->version != SEAT_HISTORY_VERSION ||
+        header->capacity != CAPACITY) {
+        *header = Header{SEAT_HISTORY_MAGIC, SEAT_HISTORY_VERSION, CAPACITY, 0, 0};
+    }
+}
+
+void SeatHistory::Ring::append(const Record& record) noexcept {
+    std::lock_guard lock{mutex};
+
+    if (header->written > 0) {
+        const Record& last = records[(header->written - 1) % CAPACITY];
+        const auto spacingMs = std::chrono::milliseconds{MIN_RECORD_SPACING}.count();
+        if (record.timeMs - last.timeMs < spacingMs && record.status == last.status && record.seats == last.seats) {
+            return;
+        }
+    }
+
+    records[header->written % CAPACITY] = record;
+    ++header->written;
+}
+
+template <typename Visitor>
+void SeatHistory::Ring::visitSince(const std::int64_t sinceMs, Visitor&& visit) {
+    std::lock_guard lock{mutex};
+
+    const std::uint64_t written = header->written;
+    const std::uint64_t count = std::min<std::uint64_t>(written, CAPACITY);
+
+    // Records are in time order, so binary search for the first one in range
+    const auto at = [&](const std::uint64_t i) -> const Record& {
+        return records[(written - count + i) % CAPACITY];
+    };
+
+    std::uint64_t low = 0;
+    std::uint64_t high = count;
+    while (low < high) {
+        const std::uint64_t middle = low + (high - low) / 2;
+        if (at(middle).timeMs < sinceMs) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    for (std::uint64_t i = low; i < count; ++i) {
+        visit(at(i));
+    }
+}
+
+EnrollmentInfo SeatHistory::toEnrollmentInfo(const Record& record) {
+    return EnrollmentInfo{static_cast<CourseStatus>(record.status),
+        std::vector<int>(record.seats.begin(), record.seats.end())};
+}
+
+SeatHistory& SeatHistory::instance() {
+    static SeatHistory seatHistory;
+    return seatHistory;
+}
+
+SeatHistory::Ring* SeatHistory::getRing(const std::string_view termCode, const std::string_view crn,
+        const bool create) {
+    const std::string key = fmt::format("{}_{}", termCode, crn);
+
+    std::lock_guard lock{m_mutex};
+    if (const auto it = m_rings.find(key); it != m_rings.end()) {
+        return it->second.get();
+    }
+
+    const std::filesystem::path path = getRingPath(termCode, crn);
+    if (!create && !std::filesystem::exists(path)) {
+        return nullptr;
+    }
+
+    std::unique_ptr<Ring> ring;
+    try {
+        std::filesystem::create_directories(path.parent_path());
+        ring = std::make_unique<Ring>(path);
+    } catch (const std::exception& e) {
+        // Remembered as missing so that every poll doesn't retry and warn again
+        spdlog::get("console")->warn("Not recording seat history for CRN {}: {}", crn, e.what());
+    }
+
+    return m_rings.emplace(key, std::move(ring)).first->second.get();
+}
+
+void SeatHistory::record(const std::string_view termCode, const std::string_view crn,
+        const EnrollmentInfo& info) noexcept {
+    try {
+        Ring* ring = getRing(termCode, crn, true);
+        if (ring == nullptr) {
+            return;
+        }
+
+        Record record{};
+        record.timeMs = toMilliseconds(std::chrono::system_clock::now());
+        record.status = static_cast<std::uint16_t>(info.status);
+        for (std::size_t i = 0; i < record.seats.size() && i < info.seats.size(); ++i) {
+            record.seats[i] = static_cast<std::int16_t>(std::clamp<int>(info.seats[i],
+                std::numeric_limits<std::int16_t>::min(), std::numeric_limits<std::int16_t>::max()));
+        }
+
+        ring->append(record);
+    } catch (const std::exception&) {
+        // Only allocations can fail here, and history isn't worth failing a seat check over
+    }
+}
+
+void SeatHistory::visitStatusesAfter(const std::string_view termCode, const std::string_view crn,
+        const std::chrono::system_clock::time_point after,
+        const std::function<void(std::chrono::system_clock::time_point, CourseStatus)>& visit) {
+    Ring* ring = getRing(termCode, crn, false);
+    if (ring == nullptr) {
+        return;
+    }
+
+    ring->visitSince(toMilliseconds(after) + 1, [&](const Record& record) {
+        visit(std::chrono::system_clock::time_point{std::chrono::milliseconds{record.timeMs}},
+            static_cast<CourseStatus>(record.status));
+    });
+}
+
+std::vector<SeatTransition> SeatHistory::getTransitions(const std::string_view termCode, const std::string_view crn,
+        const std::chrono::system_clock::time_point since) {
+    std::vector<SeatTransition> transitions;
+
+    Ring* ring = getRing(termCode, crn, false);
+    if (ring == nullptr) {
+        return transitions;
+    }
+
+    std::optional<Record> previous;
+    ring->visitSince(toMilliseconds(since), [&](const Record& record) {
+        if (previous && previous->status != record.status) {
+            transitions.push_back(SeatTransition{
+                .time = std::chrono::system_clock::time_point{std::chrono::milliseconds{record.timeMs}},
+                .before = toEnrollmentInfo(*previous),
+                .after = toEnrollmentInfo(record)
+            });
+        }
+
+        previous = record;
+    });
+
+    return transitions;
+}
@@ -0,0 +1,101 @@
+#ifndef SEATHISTORY_H
+#define SEATHISTORY_H
+
+#include "data/Enrollment.h"
+#include "util/MappedFile.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct SeatTransition {
+    std::chrono::system_clock::time_point time;
+    EnrollmentInfo before;
+    EnrollmentInfo after;
+};
+
+// The seat checks of the last RETENTION, kept per CRN in the state directory (`seats/<term>_<crn>.bin`).
+//
+// Each CRN's file is a memory-mapped ring of CAPACITY fixed-size observations, so recording one is a copy into
+// mapped memory and the file never grows. Once a ring is full, the oldest observations are overwritten.
+// Observations survive restarts, so history builds up across runs of the same term.
+//
+// An observation that doesn't change anything is only kept if MIN_RECORD_SPACING has passed since the last one,
+// so however often a CRN is checked, its ring holds at least RETENTION of history.
+class SeatHistory {
+public:
+    static constexpr std::chrono::days RETENTION{7};
+    static constexpr std::chrono::seconds MIN_RECORD_SPACING{2};
+    // About 7 MB per CRN
+    static constexpr std::uint32_t CAPACITY = RETENTION / MIN_RECORD_SPACING;
+
+    static SeatHistory& instance();
+
+    SeatHistory(const SeatHistory&) = delete;
+    SeatHistory& operator=(const SeatHistory&) = delete;
+
+    // Records the CRN's current enrollment info. Never throws; if the CRN's file can't be opened, its
+    // observations are skipped.
+    void record(std::string_view termCode, std::string_view crn, const EnrollmentInfo& info) noexcept;
+
+    // Calls visit(time, status) for every observation made after the given time, oldest first, without copying
+    // the history out
+    void visitStatusesAfter(std::string_view termCode, std::string_view crn,
+        std::chrono::system_clock::time_point after,
+        const std::function<void(std::chrono::system_clock::time_point, CourseStatus)>& visit);
+
+    // Changes of status (e.g. Closed to Open) since the given time, oldest first
+    [[nodiscard]] std::vector<SeatTransition> getTransitions(std::string_view termCode, std::string_view crn,
+        std::chrono::system_clock::time_point since);
+
+private:
+    struct Record {
+        std::int64_t timeMs;
+        std::uint16_t status;
+        std::array<std::int16_t, +SeatType::Size> seats;
+        std::uint16_t reserved;
+    };
+
+    struct Header {
+        std::array<char, 8> magic;
+        std::uint32_t version;
+        std::uint32_t capacity;
+        std::uint64_t written; // Total observations ever recorded
+        std::uint64_t reserved;
+    };
+
+    struct Ring {
+        explicit Ring(const std::filesystem::path& path);
+
+        void append(const Record& record) noexcept;
+
+        // Calls visit(record) for every record from `since` on, oldest first
+        template <typename Visitor>
+        void visitSince(std::int64_t sinceMs, Visitor&& visit);
+
+        MappedFile file;
+        Header* header;
+        Record* records;
+        std::mutex mutex;
+    };
+
+    SeatHistory() = default;
+
+    static EnrollmentInfo toEnrollmentInfo(const Record& record);
+
+    // Returns nullptr if the ring doesn't exist and `create` is false, or if it can't be opened
+    Ring* getRing(std::string_view termCode, std::string_view crn, bool create);
+
+    std::mutex m_mutex;
+    std::map<std::string, std::unique_ptr<Ring>, std::less<>> m_rings;
+};
+
+#endif // SEATHISTORY_H
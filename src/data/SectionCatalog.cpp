@@ -0,0 +1,292 @@
+#include "data/SectionCatalog.h"
+#include "data/Links.h"
+#include "util/Requests.h"
+#include "util/Utility.h"
+
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <charconv>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+
+namespace {
+constexpr std::array<char, 8> CATALOG_MAGIC{'D', 'A', 'R', 'E', 'C', 'A', 'T', 'L'};
+constexpr std::uint32_t CATALOG_VERSION = 1;
+constexpr int PAGE_SIZE = 500;
+
+std::optional<std::uint32_t> parseCrn(const std::string_view crn) noexcept {
+    std::uint32_t value = 0;
+    const auto [end, ec] = std::from_chars(crn.data(), crn.data() + crn.size(), value);
+    if (ec != std::errc{} || end != crn.data() + crn.size()) {
+        return std::nullopt;
+    }
+
+    return value;
+}
+
+std::string_view getStringMember(const rapidjson::Value& json, const char* name) {
+    if (!json.HasMember(name) || !json[name].IsString()) {
+        return {};
+    }
+
+    return {json[name].GetString(), json[name].GetStringLength()};
+}
+
+struct DownloadedSection {
+    std::uint32_t crn;
+    std::string courseCode;
+    std::string section;
+    std::string title;
+};
+
+std::vector<DownloadedSection> searchTerm(const std::string& termCode) {
+    cpr::Session session;
+    session.SetHeader(getDefaultHeaders());
+
+    // Class search only returns results for the term selected in the session
+    sendRequest(session, RequestMethod::POST, Link::Classes::TERM_SEARCH, cpr::Payload{{"term", termCode}});
+
+    std::vector<DownloadedSection> sections;
+    // Rows the search returned, including ones that are skipped, since that's what the page offset counts
+    std::size_t fetched = 0;
+    std::size_t totalCount = 0;
+
+    do {
+        const auto response = sendRequest(session, RequestMethod::GET, Link::Classes::SEARCH_RESULTS,
+            cpr::Parameters{
+                {"txt_term", termCode},
+                {"pageOffset", std::to_string(fetched)},
+                {"pageMaxSize", std::to_string(PAGE_SIZE)},
+                {"sortColumn", "subjectDescription"},
+                {"sortDirection", "asc"}
+            }
+        );
+
+        const rapidjson::Document json = parseJsonResponse(response.text);
+        if (!json.IsObject() || !json.HasMember("data") || !json["data"].IsArray() ||
+            !json.HasMember("totalCount") || !json["totalCount"].IsInt()) {
+            throw std::runtime_error{"Unexpected class search response."};
+        }
+
+        totalCount = static_cast<std::size_t>(std::max(json["totalCount"].GetInt(), 0));
+        const std::size_t pageRows = json["data"].Size();
+        fetched += pageRows;
+
+        for (const auto& result : json["data"].GetArray()) {
+            const auto crn = parseCrn(getStringMember(result, "courseReferenceNumber"));
+            if (!crn) {
+                continue;
+            }
+
+            // Same course code as the registration responses use (see processUpdate)
+            sections.push_back(DownloadedSection{
+                .crn = *crn,
+                .courseCode = formatCourseCode(std::string{getStringMember(result, "subject")},
+                    std::string{getStringMember(result, "courseDisplay")}),
+                .section = std::string{getStringMember(result, "sequenceNumber")},
+                .title = std::string{getStringMember(result, "courseTitle")}
+            });
+        }
+
+        // A short page is the last one, even if totalCount disagrees
+        if (pageRows < static_cast<std::size_t>(PAGE_SIZE)) {
+            break;
+        }
+    } while (fetched < totalCount);
+
+    return sections;
+}
+} // namespace
+
+SectionCatalog::SectionCatalog(const std::filesystem::path& path) : m_file{path} {
+    const std::span<const std::byte> data = m_file.getData();
+    if (data.size() < sizeof(Header)) {
+        throw std::runtime_error{fmt::format("{} is truncated.", path.filename().string())};
+    }
+
+    m_header = reinterpret_cast<const Header*>(data.data());
+    if (m_header->magic != CATALOG_MAGIC || m_header->version != CATALOG_VERSION) {
+        throw std::runtime_error{fmt::format("{} is from an incompatible version.", path.filename().string())};
+    }
+
+    const std::size_t count = m_header->sectionCount;
+    const std::size_t recordsOffset = sizeof(Header);
+    const std::size_t byCourseOffset = recordsOffset + count * sizeof(Record);
+    const std::size_t stringsOffset = byCourseOffset + count * sizeof(std::uint32_t);
+    if (data.size() != stringsOffset + m_header->stringsSize) {
+        throw std::runtime_error{fmt::format("{} is truncated.", path.filename().string())};
+    }
+
+    m_records = {reinterpret_cast<const Record*>(data.data() + recordsOffset), count};
+    m_byCourse = {reinterpret_cast<const std::uint32_t*>(data.data() + byCourseOffset), count};
+    m_strings = {reinterpret_cast<const char*>(data.data() + stringsOffset), m_header->stringsSize};
+
+    // Checked once here so that lookups can trust the file
+    const auto inBounds = [&](const StringRef ref) {
+        return ref.offset <= m_strings.size() && ref.length <= m_strings.size() - ref.offset;
+    };
+
+    for (const Record& record : m_records) {
+        if (!inBounds(record.courseCode) || !inBounds(record.section) || !inBounds(record.title)) {
+            throw std::runtime_error{fmt::format("{} is corrupt.", path.filename().string())};
+        }
+    }
+
+    if (std::ranges::any_of(m_byCourse, [&](const std::uint32_t index) { return index >= count; })) {
+        throw std::runtime_error{fmt::format("{} is corrupt.", path.filename().string())};
+    }
+}
+
+std::shared_ptr<const SectionCatalog> SectionCatalog::load(const std::string_view termCode) {
+    struct CachedCatalog {
+        std::filesystem::file_time_type modifiedAt;
+        std::shared_ptr<const SectionCatalog> catalog;
+    };
+
+    static std::mutex mutex;
+    static std::map<std::string, CachedCatalog, std::less<>> catalogs;
+
+    const std::filesystem::path path = getSectionCatalogPath(termCode);
+
+    std::error_code ec;
+    const auto modifiedAt = std::filesystem::last_write_time(path, ec);
+    if (ec) {
+        return nullptr;
+    }
+
+    std::lock_guard lock{mutex};
+    if (const auto it = catalogs.find(termCode); it != catalogs.end() && it->second.modifiedAt == modifiedAt) {
+        return it->second.catalog;
+    }
+
+    std::shared_ptr<const SectionCatalog> catalog;
+    try {
+        catalog = std::make_shared<const SectionCatalog>(path);
+    } catch (const std::exception& e) {
+        spdlog::get("console")->warn("Ignoring section catalog: {}", e.what());
+    }
+
+    catalogs.insert_or_assign(std::string{termCode}, CachedCatalog{modifiedAt, catalog});
+    return catalog;
+}
+
+std::string_view SectionCatalog::getString(const StringRef ref) const noexcept {
+    return m_strings.substr(ref.offset, ref.length);
+}
+
+CatalogSection SectionCatalog::makeSection(const Record& record) const noexcept {
+    return CatalogSection{
+        .crn = record.crn,
+        .courseCode = getString(record.courseCode),
+        .section = getString(record.section),
+        .title = getString(record.title)
+    };
+}
+
+std::optional<CatalogSection> SectionCatalog::findByCrn(const std::string_view crn) const {
+    const auto value = parseCrn(crn);
+    if (!value) {
+        return std::nullopt;
+    }
+
+    const auto it = std::ranges::lower_bound(m_records, *value, {}, &Record::crn);
+    if (it == m_records.end() || it->crn != *value) {
+        return std::nullopt;
+    }
+
+    return makeSection(*it);
+}
+
+std::vector<CatalogSection> SectionCatalog::findByCourse(const std::string_view courseCode) const {
+    const auto courseCodeOf = [&](const std::uint32_t index) {
+        return getString(m_records[index].courseCode);
+    };
+
+    const auto matches = std::ranges::equal_range(m_byCourse, courseCode, {}, courseCodeOf);
+
+    std::vector<CatalogSection> sections;
+    sections.reserve(matches.size());
+    for (const std::uint32_t index : matches) {
+        sections.push_back(makeSection(m_records[index]));
+    }
+
+    return sections;
+}
+
+std::size_t SectionCatalog::size() const noexcept {
+    return m_records.size();
+}
+
+std::chrono::system_clock::time_point SectionCatalog::getFetchedAt() const noexcept {
+    return std::chrono::system_clock::time_point{std::chrono::milliseconds{m_header->fetchedAtMs}};
+}
+
+std::filesystem::path getSectionCatalogPath(const std::string_view termCode) {
+    return getStateDirectory() / fmt::format("catalog_{}.bin", sanitizeFileName(termCode));
+}
+
+std::size_t downloadSectionCatalog(const std::string& termCode) {
+    using Record = SectionCatalog::Record;
+    using StringRef = SectionCatalog::StringRef;
+
+    std::vector<DownloadedSection> sections = searchTerm(termCode);
+
+    std::ranges::sort(sections, {}, &DownloadedSection::crn);
+    const auto duplicates = std::ranges::unique(sections, {}, &DownloadedSection::crn);
+    sections.erase(duplicates.begin(), duplicates.end());
+
+    // Sections of the same course share their course code and usually their title
+    std::string strings;
+    std::unordered_map<std::string, StringRef> interned;
+    const auto intern = [&](const std::string& value) {
+        const auto [it, inserted] = interned.try_emplace(value, StringRef{
+            static_cast<std::uint32_t>(strings.size()), static_cast<std::uint32_t>(value.size())});
+        if (inserted) {
+            strings += value;
+        }
+
+        return it->second;
+    };
+
+    std::vector<Record> records;
+    records.reserve(sections.size());
+    for (const DownloadedSection& section : sections) {
+        records.push_back(Record{section.crn, intern(section.courseCode), intern(section.section),
+            intern(section.title)});
+    }
+
+    std::vector<std::uint32_t> byCourse(sections.size());
+    for (std::uint32_t i = 0; i < byCourse.size(); ++i) {
+        byCourse[i] = i;
+    }
+
+    std::ranges::sort(byCourse, [&](const std::uint32_t a, const std::uint32_t b) {
+        return std::tie(sections[a].courseCode, sections[a].section) <
+            std::tie(sections[b].courseCode, sections[b].section);
+    });
+
+    const SectionCatalog::Header header{
+        .magic = CATALOG_MAGIC,
+        .version = CATALOG_VERSION,
+        .sectionCount = static_cast<std::uint32_t>(records.size()),
+        .fetchedAtMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count(),
+        .stringsSize = strings.size()
+    };
+
+    std::string contents;
+    contents.reserve(sizeof(header) + records.size() * sizeof(Record) + byCourse.size() * sizeof(std::uint32_t) +
+        strings.size());
+    contents.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    contents.append(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(Record));
+    contents.append(reinterpret_cast<const char*>(byCourse.data()), byCourse.size() * sizeof(std::uint32_t));
+    contents += strings;
+
+    writePrivateFile(getSectionCatalogPath(termCode), contents);
+    return records.size();
+}
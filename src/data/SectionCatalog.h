@@ -0,0 +1,87 @@
+#ifndef SECTIONCATALOG_H
+#define SECTIONCATALOG_H
+
+#include "util/MappedFile.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct CatalogSection {
+    std::uint32_t crn = 0;
+    std::string_view courseCode;
+    std::string_view section;
+    std::string_view title;
+};
+
+// Every section offered in a term, downloaded ahead of time (see downloadSectionCatalog) so that course details
+// can be looked up without asking the portal.
+//
+// The catalog file is memory-mapped rather than parsed: a header, then one record per section sorted by CRN, then
+// the records' indices sorted by course code, then the string pool the records point into. Lookups are binary
+// searches straight over the mapping. The views returned point into the mapping and live as long as the catalog.
+class SectionCatalog {
+public:
+    // Throws if the file is missing, truncated, or from a different version.
+    explicit SectionCatalog(const std::filesystem::path& path);
+
+    // Returns nullptr if the term has no catalog or it can't be read. Catalogs are opened once and shared, and
+    // reopened if the file is replaced.
+    static std::shared_ptr<const SectionCatalog> load(std::string_view termCode);
+
+    [[nodiscard]] std::optional<CatalogSection> findByCrn(std::string_view crn) const;
+
+    // Sorted by section
+    [[nodiscard]] std::vector<CatalogSection> findByCourse(std::string_view courseCode) const;
+
+    [[nodiscard]] std::size_t size() const noexcept;
+    [[nodiscard]] std::chrono::system_clock::time_point getFetchedAt() const noexcept;
+
+private:
+    struct StringRef {
+        std::uint32_t offset;
+        std::uint32_t length;
+    };
+
+    struct Record {
+        std::uint32_t crn;
+        StringRef courseCode;
+        StringRef section;
+        StringRef title;
+    };
+
+    struct Header {
+        std::array<char, 8> magic;
+        std::uint32_t version;
+        std::uint32_t sectionCount;
+        std::int64_t fetchedAtMs;
+        std::uint64_t stringsSize;
+    };
+
+    [[nodiscard]] std::string_view getString(StringRef ref) const noexcept;
+    [[nodiscard]] CatalogSection makeSection(const Record& record) const noexcept;
+
+    MappedFile m_file;
+    const Header* m_header = nullptr;
+    std::span<const Record> m_records;
+    std::span<const std::uint32_t> m_byCourse;
+    std::string_view m_strings;
+
+    friend std::size_t downloadSectionCatalog(const std::string& termCode);
+};
+
+// Where the term's catalog is stored in the state directory.
+std::filesystem::path getSectionCatalogPath(std::string_view termCode);
+
+// Downloads every section in the term through class search and replaces the term's catalog with it.
+// Returns the number of sections. Throws if the search fails.
+std::size_t downloadSectionCatalog(const std::string& termCode);
+
+#endif // SECTIONCATALOG_H
@@ -4,8 +4,12 @@
 #include "util/Utility.h"
 
 #include <rapidjson/document.h>
+#include <rapidjson/writer.h>
 #include <spdlog/spdlog.h>
 
+#include <fstream>
+#include <mutex>
+#include <sstream>
 #include <vector>
 
 namespace {
@@ -38,6 +42,59 @@ std::unordered_map<std::string, std::string> getTerms() {
     return terms;
 }
 
+std::filesystem::path getTermCachePath() {
+    return getStateDirectory() / "terms.json";
+}
+
+// Term codes never change once published, so a cached mapping lets restarts skip the getTerms request.
+std::unordered_map<std::string, std::string> loadCachedTerms() {
+    std::unordered_map<std::string, std::string> terms;
+
+    try {
+        std::ifstream file{getTermCachePath(), std::ios::binary};
+        if (!file) {
+            return terms;
+        }
+
+        std::ostringstream contents;
+        contents << file.rdbuf();
+
+        const rapidjson::Document document = parseJsonResponse(contents.str());
+        if (!document.IsObject()) {
+            return terms;
+        }
+
+        for (const auto& member : document.GetObject()) {
+            if (member.value.IsString()) {
+                terms.insert({member.name.GetString(), member.value.GetString()});
+            }
+        }
+    } catch (const std::exception&) {
+        terms.clear(); // A corrupt cache just means fetching from the server again
+    }
+
+    return terms;
+}
+
+void saveCachedTerms(const std::unordered_map<std::string, std::string>& terms) {
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer writer{buffer};
+
+    writer.StartObject();
+    for (const auto& [description, code] : terms) {
+        writer.Key(description.c_str(), static_cast<rapidjson::SizeType>(description.size()));
+        writer.String(code.c_str(), static_cast<rapidjson::SizeType>(code.size()));
+    }
+    writer.EndObject();
+
+    try {
+        std::ofstream file{getTermCachePath(), std::ios::binary | std::ios::trunc};
+        file.write(buffer.GetString(), static_cast<std::streamsize>(buffer.GetLength()));
+    } catch (const std::exception& e) {
+        spdlog::get("console")->warn("Could not cache terms: {}", e.what());
+    }
+}
+
 // Converts the term from "YYYY Season Campus" to "YYYYSC"
 // Season: Summer -> 1, Fall -> 2, Winter -> 3, Spring -> 4 (If Summer or Fall, then the year is incremented by 1)
 // Campus: Foothill -> 1, De Anza -> 2
@@ -80,15 +137,29 @@ std::string buildTerm(const std::string& termDescription) {
 } // namespace
 
 std::string getTermCode(const std::string& termDescription) {
-    static std::unordered_map<std::string, std::string> terms;
+    static std::mutex termsMutex;
+    static std::unordered_map<std::string, std::string> terms = loadCachedTerms();
+    static bool fetchedTerms = false;
+    static bool serverHasTerms = false;
 
-    static std::once_flag termsFlag;
-    std::call_once(termsFlag, [] {
-        terms = getTerms();
-    });
+    std::lock_guard lock{termsMutex};
+
+    if (!terms.contains(termDescription) && !fetchedTerms) {
+        const auto serverTerms = getTerms();
+        fetchedTerms = true;
+        serverHasTerms = !serverTerms.empty();
+
+        for (const auto& [description, code] : serverTerms) {
+            terms.insert_or_assign(description, code);
+        }
+
+        if (serverHasTerms) {
+            saveCachedTerms(terms);
+        }
+    }
 
     if (!terms.contains(termDescription)) {
-        if (terms.empty()) {
+        if (!serverHasTerms) {
             spdlog::get("console")->warn("Could not get terms from server. Manually building term code.");
             return buildTerm(termDescription);
         }
@@ -0,0 +1,91 @@
+// dare-events: renders the binary events files written by EventLog as text.
+// Usage: dare-events <events_*.bin>...
+
+#include "events/EventRecord.h"
+
+#include <fmt/chrono.h>
+#include <fmt/format.h>
+
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <string_view>
+#include <unordered_map>
+
+namespace {
+constexpr std::array<std::string_view, 7> LEVEL_NAMES = {
+    "trace", "debug", "info", "warning", "error", "critical", "off"
+};
+
+std::string formatTime(const std::int64_t timeNs) {
+    const std::chrono::system_clock::time_point time{
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds{timeNs})};
+    const std::time_t seconds = std::chrono::system_clock::to_time_t(time);
+    const auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(
+        time.time_since_epoch()).count() % 1000;
+
+    return fmt::format("{:%Y-%m-%d %H:%M:%S}.{:03}", fmt::localtime(seconds), milliseconds);
+}
+
+bool decodeFile(const char* path) {
+    std::ifstream file{path, std::ios::binary};
+    if (!file) {
+        fmt::print(stderr, "Could not open {}\n", path);
+        return false;
+    }
+
+    std::array<char, EVENT_FILE_MAGIC.size()> magic{};
+    std::uint32_t version = 0;
+    file.read(magic.data(), magic.size());
+    file.read(reinterpret_cast<char*>(&version), sizeof(version));
+
+    if (!file || magic != EVENT_FILE_MAGIC) {
+        fmt::print(stderr, "{} is not a DARE events file.\n", path);
+        return false;
+    }
+
+    if (version != EVENT_FILE_VERSION) {
+        fmt::print(stderr, "{} is version {}, but this decoder reads version {}.\n", path, version,
+            EVENT_FILE_VERSION);
+        return false;
+    }
+
+    std::unordered_map<std::uint32_t, std::string> taskNames;
+    EventRecord record;
+
+    while (file.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+        if (record.type == EventType::TaskStarted) {
+            taskNames[record.task] = std::string{record.getText()};
+        }
+
+        const auto name = taskNames.find(record.task);
+        const std::string_view level = record.level < LEVEL_NAMES.size() ? LEVEL_NAMES[record.level] : "?";
+
+        fmt::print("[{}] [{}] [{}] {}\n", formatTime(record.timeNs), level,
+            name != taskNames.end() ? std::string_view{name->second} : std::string_view{"?"}, formatEvent(record));
+    }
+
+    // A partial record means the writer was cut off mid-write
+    if (file.gcount() != 0) {
+        fmt::print(stderr, "{} ends with a truncated record.\n", path);
+    }
+
+    return true;
+}
+} // namespace
+
+int main(const int argc, char* argv[]) {
+    if (argc < 2) {
+        fmt::print(stderr, "Usage: {} <events file>...\n", argv[0]);
+        return 1;
+    }
+
+    bool succeeded = true;
+    for (int i = 1; i < argc; ++i) {
+        succeeded = decodeFile(argv[i]) && succeeded;
+    }
+
+    return succeeded ? 0 : 1;
+}
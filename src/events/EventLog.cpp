@@ -0,0 +1,255 @@
+#include "events/EventLog.h"
+#include "util/Utility.h"
+
+#include <fmt/format.h>
+#include <spdlog/async.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <charconv>
+
+namespace {
+std::int32_t parseCrn(const std::string& crn) noexcept {
+    std::int32_t value = 0;
+    std::from_chars(crn.data(), crn.data() + crn.size(), value);
+    return value;
+}
+} // namespace
+
+EventRecorder::EventRecorder(std::shared_ptr<EventRing> ring, const std::uint32_t task) noexcept
+    : m_ring{std::move(ring)}, m_task{task} {}
+
+EventRecorder::~EventRecorder() {
+    if (m_ring) {
+        EventLog::instance().unregisterTask(m_task);
+    }
+}
+
+void EventRecorder::record(EventRecord& record) const noexcept {
+    if (!m_ring) {
+        return;
+    }
+
+    record.timeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    record.task = m_task;
+    m_ring->tryPush(record);
+}
+
+void EventRecorder::seatCheck(const CRN& crn, const EnrollmentInfo& previous) const noexcept {
+    const bool firstCheck = previous.seats.empty();
+    const bool changed = !firstCheck && previous != crn.enrollmentInfo;
+
+    EventRecord record;
+    record.type = changed ? EventType::SeatChange : EventType::SeatCheck;
+    record.level = firstCheck || changed ? spdlog::level::info : spdlog::level::debug;
+    record.values[0] = parseCrn(crn.value);
+    record.values[1] = static_cast<std::int32_t>(crn.enrollmentInfo.status);
+    std::copy_n(crn.enrollmentInfo.seats.begin(), std::min<std::size_t>(crn.enrollmentInfo.seats.size(),
+        PREVIOUS_VALUES - 2), record.values.begin() + 2);
+
+    if (changed) {
+        record.values[PREVIOUS_VALUES] = static_cast<std::int32_t>(previous.status);
+        record.values[PREVIOUS_VALUES + 1] = previous.seats[+SeatType::EnrollmentSeatsAvailable];
+        record.values[PREVIOUS_VALUES + 2] = previous.seats[+SeatType::WaitlistSeatsAvailable];
+    }
+
+    record.setText(crn.courseCode);
+    this->record(record);
+}
+
+void EventRecorder::enqueued(const CRN& crn) const noexcept {
+    EventRecord record;
+    record.type = EventType::Enqueued;
+    record.level = spdlog::level::info;
+    record.values[0] = parseCrn(crn.value);
+    record.setText(crn.courseCode);
+    this->record(record);
+}
+
+void EventRecorder::nextCheck(const std::chrono::milliseconds delay) const noexcept {
+    EventRecord record;
+    record.type = EventType::NextCheck;
+    record.level = spdlog::level::info;
+    record.values[0] = static_cast<std::int32_t>(delay.count());
+    this->record(record);
+}
+
+void EventRecorder::stageTiming(const std::string_view stage, const std::chrono::milliseconds duration) const noexcept {
+    EventRecord record;
+    record.type = EventType::StageTiming;
+    record.level = spdlog::level::debug;
+    record.values[0] = static_cast<std::int32_t>(duration.count());
+    record.setText(stage);
+    this->record(record);
+}
+
+EventLog& EventLog::instance() {
+    static EventLog eventLog;
+    return eventLog;
+}
+
+EventLog::~EventLog() {
+    stop();
+}
+
+EventRecorder EventLog::registerTask(std::string loggerName, const bool persist) {
+    auto ring = std::make_shared<EventRing>();
+
+    std::lock_guard lock{m_mutex};
+    if (m_stopping) {
+        return {};
+    }
+
+    const std::uint32_t task = m_nextTask++;
+    m_sources.push_back(Source{task, std::move(loggerName), persist, ring});
+
+    if (persist) {
+        openFile();
+
+        // Lets the decoder map task numbers back to names
+        EventRecord started;
+        started.timeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        started.task = task;
+        started.type = EventType::TaskStarted;
+        started.level = spdlog::level::debug;
+        started.setText(m_sources.back().loggerName);
+        m_file.write(reinterpret_cast<const char*>(&started), sizeof(started));
+    }
+
+    if (!m_future.valid()) {
+        m_future = std::async(std::launch::async, [this] {
+            run();
+        });
+    }
+
+    return EventRecorder{std::move(ring), task};
+}
+
+void EventLog::unregisterTask(const std::uint32_t task) {
+    std::lock_guard lock{m_mutex};
+
+    const auto it = std::ranges::find(m_sources, task, &Source::task);
+    if (it == m_sources.end()) {
+        return;
+    }
+
+    drain(*it);
+    m_sources.erase(it);
+}
+
+void EventLog::drainLogger(const std::string_view loggerName) {
+    std::lock_guard lock{m_mutex};
+
+    for (Source& source : m_sources) {
+        if (source.loggerName == loggerName) {
+            drain(source);
+        }
+    }
+}
+
+void EventLog::stop() {
+    {
+        std::lock_guard lock{m_mutex};
+        m_stopping = true;
+    }
+
+    m_stopCv.notify_all();
+
+    if (m_future.valid()) {
+        m_future.wait();
+    }
+}
+
+// Expects m_mutex to be held
+void EventLog::openFile() {
+    if (m_file.is_open()) {
+        return;
+    }
+
+    const std::filesystem::path logsDirectory = getExecutableDirectory() + "/logs";
+    std::filesystem::create_directory(logsDirectory);
+
+    auto timestamp = getCurrentLocalTime();
+    std::ranges::replace(timestamp, ':', '-');
+    std::ranges::replace(timestamp, ' ', '_');
+
+    m_file.open(logsDirectory / fmt::format("events_{}.bin", timestamp), std::ios::binary | std::ios::trunc);
+    m_file.write(EVENT_FILE_MAGIC.data(), EVENT_FILE_MAGIC.size());
+    m_file.write(reinterpret_cast<const char*>(&EVENT_FILE_VERSION), sizeof(EVENT_FILE_VERSION));
+}
+
+// Expects m_mutex to be held
+void EventLog::drain(Source& source) {
+    const auto logger = spdlog::get(source.loggerName);
+
+    EventRecord record;
+    while (source.ring->tryPop(record)) {
+        if (source.persist) {
+            m_file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+            m_fileDirty = true;
+        }
+
+        if (logger) {
+            const auto time = std::chrono::system_clock::time_point{
+                std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds{record.timeNs})};
+            logger->log(time, spdlog::source_loc{}, static_cast<spdlog::level::level_enum>(record.level),
+                formatEvent(record));
+        }
+    }
+
+    if (const std::uint64_t dropped = source.ring->getDropped(); dropped > source.reportedDrops) {
+        if (logger) {
+            logger->warn("Dropped {} event{} because the event log fell behind.", dropped - source.reportedDrops,
+                determinePlural(dropped - source.reportedDrops));
+        }
+
+        source.reportedDrops = dropped;
+    }
+}
+
+void EventLog::reportOverruns() {
+    // Loggers drop their oldest messages instead of blocking tasks when the queue is full
+    const auto threadPool = spdlog::thread_pool();
+    if (!threadPool) {
+        return;
+    }
+
+    const std::size_t overruns = threadPool->overrun_counter();
+    if (overruns <= m_reportedOverruns) {
+        return;
+    }
+
+    if (const auto console = spdlog::get("console")) {
+        console->warn("Dropped {} log message{} because logging fell behind.", overruns - m_reportedOverruns,
+            determinePlural(overruns - m_reportedOverruns));
+    }
+
+    m_reportedOverruns = overruns;
+}
+
+void EventLog::run() {
+    std::unique_lock lock{m_mutex};
+
+    while (true) {
+        const bool stopping = m_stopCv.wait_for(lock, DRAIN_INTERVAL, [&] {
+            return m_stopping;
+        });
+
+        for (Source& source : m_sources) {
+            drain(source);
+        }
+
+        reportOverruns();
+
+        if (m_fileDirty) {
+            m_file.flush();
+            m_fileDirty = false;
+        }
+
+        if (stopping) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,95 @@
+#ifndef EVENTLOG_H
+#define EVENTLOG_H
+
+#include "events/EventRing.h"
+#include "util/Course.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// A task's handle for recording hot-path events. Recording copies a fixed-size record into the task's ring and
+// never blocks or formats anything. If the ring is full, the event is dropped and counted.
+class EventRecorder {
+public:
+    EventRecorder() = default;
+    EventRecorder(std::shared_ptr<EventRing> ring, std::uint32_t task) noexcept;
+    ~EventRecorder();
+
+    EventRecorder(const EventRecorder&) = delete;
+    EventRecorder& operator=(const EventRecorder&) = delete;
+
+    // Logged at info level when the seats changed since `previous` (or it's the first check), otherwise at debug.
+    void seatCheck(const CRN& crn, const EnrollmentInfo& previous) const noexcept;
+    void enqueued(const CRN& crn) const noexcept;
+    void nextCheck(std::chrono::milliseconds delay) const noexcept;
+    void stageTiming(std::string_view stage, std::chrono::milliseconds duration) const noexcept;
+
+private:
+    void record(EventRecord& record) const noexcept;
+
+    std::shared_ptr<EventRing> m_ring;
+    std::uint32_t m_task = 0;
+};
+
+// Turns every task's recorded events into text on a background thread, logging them through the task's spdlog
+// logger with their original timestamps. Events from tasks with log files enabled are also appended to a binary
+// events file in the logs folder, which `dare-events` can render.
+class EventLog {
+public:
+    static EventLog& instance();
+
+    EventLog(const EventLog&) = delete;
+    EventLog& operator=(const EventLog&) = delete;
+
+    // Events are logged through the spdlog logger named `loggerName`, if it's still registered by then.
+    EventRecorder registerTask(std::string loggerName, bool persist);
+
+    // Drains the task's remaining events right away
+    void unregisterTask(std::uint32_t task);
+
+    // Hands every event recorded so far for the logger to it right away, instead of within DRAIN_INTERVAL
+    void drainLogger(std::string_view loggerName);
+
+    // Drains everything and stops the writer thread.
+    void stop();
+
+private:
+    struct Source {
+        std::uint32_t task;
+        std::string loggerName;
+        bool persist;
+        std::shared_ptr<EventRing> ring;
+        std::uint64_t reportedDrops = 0;
+    };
+
+    EventLog() = default;
+    ~EventLog();
+
+    void run();
+    void drain(Source& source);
+    void reportOverruns();
+    void openFile();
+
+    static constexpr std::chrono::milliseconds DRAIN_INTERVAL{20};
+
+    std::mutex m_mutex;
+    std::condition_variable m_stopCv;
+    bool m_stopping = false;
+    std::vector<Source> m_sources;
+    std::uint32_t m_nextTask = 0;
+    std::ofstream m_file;
+    bool m_fileDirty = false;
+    std::size_t m_reportedOverruns = 0;
+    std::future<void> m_future;
+};
+
+#endif // EVENTLOG_H
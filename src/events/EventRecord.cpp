@@ -0,0 +1,72 @@
+#include "events/EventRecord.h"
+#include "data/Enrollment.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+
+namespace {
+// Records can come from a file, so anything cast to an enum is checked first
+bool isCourseStatus(const std::int32_t value) {
+    return value >= static_cast<std::int32_t>(CourseStatus::Closed) &&
+        value <= static_cast<std::int32_t>(CourseStatus::WaitlistSoon);
+}
+
+std::string describeCorruption(const EventRecord& record, const std::int32_t status) {
+    return fmt::format("Corrupt record of type {}: course status {} is out of range",
+        static_cast<int>(record.type), status);
+}
+
+EnrollmentInfo getEnrollmentInfo(const EventRecord& record) {
+    return EnrollmentInfo{
+        static_cast<CourseStatus>(record.values[1]),
+        std::vector<int>(record.values.begin() + 2, record.values.begin() + 2 + +SeatType::Size)
+    };
+}
+} // namespace
+
+void EventRecord::setText(const std::string_view value) noexcept {
+    textLength = static_cast<std::uint16_t>(std::min(value.size(), text.size()));
+    std::copy_n(value.data(), textLength, text.data());
+}
+
+std::string_view EventRecord::getText() const noexcept {
+    return std::string_view{text.data(), std::min<std::size_t>(textLength, text.size())};
+}
+
+std::string formatEvent(const EventRecord& record) {
+    switch (record.type) {
+        case EventType::TaskStarted:
+            return fmt::format("Started task {}", record.getText());
+        case EventType::SeatCheck:
+            if (!isCourseStatus(record.values[1])) {
+                return describeCorruption(record, record.values[1]);
+            }
+
+            return fmt::format("[{}] {} - {}", record.values[0], record.getText(), getEnrollmentInfo(record));
+        case EventType::SeatChange: {
+            for (const std::int32_t status : {record.values[1], record.values[PREVIOUS_VALUES]}) {
+                if (!isCourseStatus(status)) {
+                    return describeCorruption(record, status);
+                }
+            }
+
+            std::vector<int> previousSeats(+SeatType::Size);
+            previousSeats[+SeatType::EnrollmentSeatsAvailable] = record.values[PREVIOUS_VALUES + 1];
+            previousSeats[+SeatType::WaitlistSeatsAvailable] = record.values[PREVIOUS_VALUES + 2];
+            const EnrollmentInfo previous{static_cast<CourseStatus>(record.values[PREVIOUS_VALUES]),
+                std::move(previousSeats)};
+
+            return fmt::format("[{}] {} - {} (was {})", record.values[0], record.getText(),
+                getEnrollmentInfo(record), previous);
+        }
+        case EventType::Enqueued:
+            return fmt::format("Enqueuing [{}] {}.", record.values[0], record.getText());
+        case EventType::NextCheck:
+            return fmt::format("Checking again in {:.2f} seconds.", record.values[0] / 1000.0);
+        case EventType::StageTiming:
+            return fmt::format("{} took {} ms", record.getText(), record.values[0]);
+    }
+
+    return fmt::format("Unknown event type {}", static_cast<int>(record.type));
+}
@@ -0,0 +1,49 @@
+#ifndef EVENTRECORD_H
+#define EVENTRECORD_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+enum class EventType : std::uint8_t {
+    TaskStarted,    // text: task ID
+    SeatCheck,      // values: CRN, CourseStatus, SeatType::Size seat counts; text: course code
+    SeatChange,     // values: as SeatCheck, then the previous CourseStatus and enrollment/waitlist seats available
+    Enqueued,       // values: CRN; text: course code
+    NextCheck,      // values: delay in ms
+    StageTiming     // values: duration in ms; text: stage
+};
+
+// Fixed-size record of a hot-path event. Arguments are stored raw and only turned into text later,
+// by the EventLog writer thread or the dare-events decoder.
+struct EventRecord {
+    std::int64_t timeNs = 0;        // System clock, since the epoch
+    std::uint32_t task = 0;         // Assigned by EventLog::registerTask
+    EventType type{};
+    std::uint8_t level = 0;         // spdlog::level::level_enum
+    std::uint16_t textLength = 0;
+    std::array<std::int32_t, 12> values{};
+    std::array<char, 32> text{};
+
+    // Truncates to fit
+    void setText(std::string_view value) noexcept;
+    [[nodiscard]] std::string_view getText() const noexcept;
+};
+
+static_assert(std::is_trivially_copyable_v<EventRecord>);
+
+// Index of the previous state in a SeatChange record's values
+inline constexpr std::size_t PREVIOUS_VALUES = 2 + 6;
+
+// Event files start with this, followed by EVENT_FILE_VERSION and then raw records in the writer's byte order
+inline constexpr std::array<char, 8> EVENT_FILE_MAGIC = {'D', 'A', 'R', 'E', 'E', 'V', 'T', 'S'};
+inline constexpr std::uint32_t EVENT_FILE_VERSION = 2;
+
+// Renders the message of a record the same way the task logger would, e.g. "[40123] MATH 1A - Closed - No Seats
+// Available". Records with values out of range, e.g. from a damaged file, are described as corrupt instead.
+std::string formatEvent(const EventRecord& record);
+
+#endif // EVENTRECORD_H
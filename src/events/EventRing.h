@@ -0,0 +1,80 @@
+#ifndef EVENTRING_H
+#define EVENTRING_H
+
+#include "events/EventRecord.h"
+
+#include <atomic>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Bounded lock-free ring with any number of producers and a single consumer.
+//
+// Each slot carries a sequence number saying whose turn it is: a producer claims a slot by advancing the head,
+// fills it in, then publishes it by bumping the sequence. When the ring is full, push fails and the drop is
+// counted instead of waiting.
+class EventRing {
+public:
+    static constexpr std::size_t CAPACITY = 1024;
+
+    EventRing() noexcept {
+        for (std::size_t i = 0; i < CAPACITY; ++i) {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool tryPush(const EventRecord& record) noexcept {
+        std::size_t position = m_head.load(std::memory_order_relaxed);
+
+        while (true) {
+            Slot& slot = m_slots[position % CAPACITY];
+            const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+
+            if (difference == 0) {
+                if (m_head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    slot.record = record;
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            } else {
+                position = m_head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Only one thread may pop at a time
+    bool tryPop(EventRecord& record) noexcept {
+        Slot& slot = m_slots[m_tail % CAPACITY];
+        if (slot.sequence.load(std::memory_order_acquire) != m_tail + 1) {
+            return false;
+        }
+
+        record = slot.record;
+        slot.sequence.store(m_tail + CAPACITY, std::memory_order_release);
+        ++m_tail;
+        return true;
+    }
+
+    [[nodiscard]] std::uint64_t getDropped() const noexcept {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Slot {
+        std::atomic<std::size_t> sequence;
+        EventRecord record;
+    };
+
+    std::array<Slot, CAPACITY> m_slots;
+
+    // Kept on separate cache lines so producers and the consumer don't contend
+    alignas(64) std::atomic<std::size_t> m_head{0};
+    alignas(64) std::size_t m_tail = 0;
+    alignas(64) std::atomic<std::uint64_t> m_dropped{0};
+};
+
+#endif // EVENTRING_H
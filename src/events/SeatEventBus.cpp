@@ -0,0 +1,75 @@
+#include "events/SeatEventBus.h"
+
+#include <algorithm>
+
+SeatEventBus::Subscription::Subscription(std::pair<std::string, std::string> key, const std::uint64_t id) noexcept
+    : m_key{std::move(key)}, m_id{id} {}
+
+SeatEventBus::Subscription::Subscription(Subscription&& other) noexcept
+    : m_key{std::move(other.m_key)}, m_id{std::exchange(other.m_id, 0)} {}
+
+SeatEventBus::Subscription::~Subscription() {
+    if (m_id != 0) {
+        SeatEventBus::instance().unsubscribe(m_key, m_id);
+    }
+}
+
+SeatEventBus& SeatEventBus::instance() {
+    static SeatEventBus bus;
+    return bus;
+}
+
+SeatEventBus::Subscription SeatEventBus::subscribe(std::string termCode, std::string crn, const void* owner,
+        Callback callback) {
+    std::pair key{std::move(termCode), std::move(crn)};
+
+    std::lock_guard lock{m_mutex};
+    const std::uint64_t id = m_nextId++;
+    m_subscribers[key].push_back(Subscriber{id, owner, std::move(callback)});
+
+    return Subscription{std::move(key), id};
+}
+
+void SeatEventBus::unsubscribe(const std::pair<std::string, std::string>& key, const std::uint64_t id) {
+    std::lock_guard lock{m_mutex};
+
+    const auto it = m_subscribers.find(key);
+    if (it == m_subscribers.end()) {
+        return;
+    }
+
+    std::erase_if(it->second, [&](const Subscriber& subscriber) {
+        return subscriber.id == id;
+    });
+
+    if (it->second.empty()) {
+        m_subscribers.erase(it);
+    }
+}
+
+void SeatEventBus::publish(const SeatOpening& opening, const void* publisher) {
+    std::lock_guard lock{m_mutex};
+
+    const auto it = m_subscribers.find(std::pair{opening.termCode, opening.crn});
+    if (it == m_subscribers.end()) {
+        return;
+    }
+
+    for (const Subscriber& subscriber : it->second) {
+        if (subscriber.owner != publisher) {
+            subscriber.callback(opening);
+        }
+    }
+}
+
+void SeatOpeningInbox::deliver(const SeatOpening& opening) {
+    std::lock_guard lock{m_mutex};
+    if (!m_opening) {
+        m_opening = opening;
+    }
+}
+
+std::optional<SeatOpening> SeatOpeningInbox::take() {
+    std::lock_guard lock{m_mutex};
+    return std::exchange(m_opening, std::nullopt);
+}
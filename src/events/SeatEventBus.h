@@ -0,0 +1,85 @@
+#ifndef SEATEVENTBUS_H
+#define SEATEVENTBUS_H
+
+#include "data/Enrollment.h"
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+struct SeatOpening {
+    std::string termCode;
+    std::string crn;
+    CourseStatus status = CourseStatus::Open;
+    std::chrono::steady_clock::time_point observedAt;
+};
+
+// Lets a task that sees a CRN open tell every other task in the process watching the same CRN, so they can check
+// right away instead of finishing their sleep.
+class SeatEventBus {
+public:
+    // Called on the publishing task's thread while the bus is locked, so it must be quick and must not use the bus
+    using Callback = std::function<void(const SeatOpening&)>;
+
+    // Unsubscribes when destroyed
+    class Subscription {
+    public:
+        Subscription() = default;
+        Subscription(std::pair<std::string, std::string> key, std::uint64_t id) noexcept;
+        ~Subscription();
+
+        Subscription(const Subscription&) = delete;
+        Subscription& operator=(const Subscription&) = delete;
+        Subscription(Subscription&& other) noexcept;
+        Subscription& operator=(Subscription&&) = delete;
+
+    private:
+        std::pair<std::string, std::string> m_key;
+        std::uint64_t m_id = 0;
+    };
+
+    static SeatEventBus& instance();
+
+    SeatEventBus(const SeatEventBus&) = delete;
+    SeatEventBus& operator=(const SeatEventBus&) = delete;
+
+    // `owner` identifies the subscribing task so that it isn't told about its own observations
+    [[nodiscard]] Subscription subscribe(std::string termCode, std::string crn, const void* owner, Callback callback);
+
+    void publish(const SeatOpening& opening, const void* publisher);
+
+private:
+    struct Subscriber {
+        std::uint64_t id;
+        const void* owner;
+        Callback callback;
+    };
+
+    SeatEventBus() = default;
+
+    void unsubscribe(const std::pair<std::string, std::string>& key, std::uint64_t id);
+
+    std::mutex m_mutex;
+    std::uint64_t m_nextId = 1;
+    std::map<std::pair<std::string, std::string>, std::vector<Subscriber>, std::less<>> m_subscribers;
+};
+
+// A task's pending opening from the bus, kept until the task gets around to acting on it
+class SeatOpeningInbox {
+public:
+    // Keeps the earliest opening if several arrive before the task takes one
+    void deliver(const SeatOpening& opening);
+    std::optional<SeatOpening> take();
+
+private:
+    std::mutex m_mutex;
+    std::optional<SeatOpening> m_opening;
+};
+
+#endif // SEATEVENTBUS_H
@@ -1,21 +1,42 @@
+#include "control/Coordinator.h"
+#include "data/SectionCatalog.h"
+#include "data/Terms.h"
+#include "events/EventLog.h"
 #include "task/TaskManager.h"
+#include "util/DiscordNotifier.h"
 #include "util/Utility.h"
 #include "version/Version.h"
 
-#include <date/tz.h>
 #include <spdlog/async.h>
 #include <spdlog/spdlog.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 
 #include <csignal>
+#include <filesystem>
 #include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
 
 namespace {
 std::unique_ptr<TaskManager> g_taskManager;
+std::unique_ptr<Coordinator> g_coordinator;
+
+struct CommandLineOptions {
+    std::optional<std::filesystem::path> controlSocket;
+    std::optional<InstanceRole> role;
+    std::optional<std::filesystem::path> stateDirectory;
+    bool worker = false;
+    std::vector<std::filesystem::path> coordinatedWorkers;
+    std::optional<std::string> catalogTerm;
+};
 
 void stopTaskManager() {
     if (g_taskManager) {
         g_taskManager->stop();
+    } else if (g_coordinator) {
+        g_coordinator->stop();
     } else {
         std::exit(0);
     }
@@ -44,17 +65,6 @@ extern "C" void stopTasks(int) {
 }
 #endif
 
-void setupDate() {
-    try {
-        const auto tzdataPath = std::filesystem::path(getExecutableDirectory()) / "tzdata";
-        date::set_install(tzdataPath.string());
-        auto& db = date::get_tzdb_list();
-    } catch (const std::exception& e) {
-        spdlog::error("Failed to initialize timezone database: {}", e.what());
-        throw;
-    }
-}
-
 void setupSignalHandlers() {
 #if defined(_WIN32)
     SetConsoleCtrlHandler(handleConsoleEvent, TRUE);
@@ -68,7 +78,8 @@ void setupSignalHandlers() {
 }
 
 void setupLogging() {
-    static constexpr std::size_t QUEUE_SIZE = 512; // Could honestly be way lower since we don't print that much
+    // Full queues drop their oldest messages rather than stall a task, so leave plenty of room
+    static constexpr std::size_t QUEUE_SIZE = 8192;
     static constexpr std::size_t THREAD_COUNT = 1;
     spdlog::init_thread_pool(QUEUE_SIZE, THREAD_COUNT);
 
@@ -80,23 +91,144 @@ void setupLogging() {
         "console",
         spdlog::sinks_init_list{consoleSink},
         spdlog::thread_pool(),
-        spdlog::async_overflow_policy::block);
+        spdlog::async_overflow_policy::overrun_oldest);
     console_logger->set_level(spdlog::level::info);
     spdlog::register_logger(console_logger);
+
+    // Task log files compress in batches, so they're only flushed every so often instead of on every line
+    static constexpr std::chrono::seconds FLUSH_INTERVAL{5};
+    spdlog::flush_every(FLUSH_INTERVAL);
+}
+
+int fetchCatalog(const std::string& term) {
+    const auto console = spdlog::get("console");
+
+    try {
+        const auto startTime = std::chrono::steady_clock::now();
+        const std::size_t count = downloadSectionCatalog(getTermCode(term));
+        const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - startTime);
+
+        console->info("Saved {} section{} for {} in {} ms.", count, determinePlural(count), term, duration.count());
+        return 0;
+    } catch (const std::exception& e) {
+        console->error("Failed to download the section catalog for {}: {}", term, e.what());
+        return 1;
+    }
+}
+
+CommandLineOptions parseCommandLine(const int argc, char* argv[]) {
+    CommandLineOptions options;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+
+        if (arg == "--control-socket") {
+            if (i + 1 < argc && !std::string_view{argv[i + 1]}.starts_with("--")) {
+                options.controlSocket = argv[++i];
+            } else {
+                options.controlSocket = std::filesystem::path{getExecutableDirectory()} / "dare.sock";
+            }
+        } else if (arg == "--role") {
+            const std::string_view role = i + 1 < argc ? std::string_view{argv[++i]} : std::string_view{};
+            if (role == "primary") {
+                options.role = InstanceRole::Primary;
+            } else if (role == "standby") {
+                options.role = InstanceRole::Standby;
+            } else {
+                throw std::runtime_error{"--role must be either 'primary' or 'standby'."};
+            }
+        } else if (arg == "--state-dir") {
+            if (i + 1 >= argc) {
+                throw std::runtime_error{"--state-dir requires a path."};
+            }
+
+            options.stateDirectory = argv[++i];
+        } else if (arg == "--worker") {
+            options.worker = true;
+        } else if (arg == "--coordinator") {
+            if (i + 1 >= argc) {
+                throw std::runtime_error{"--coordinator requires a comma-separated list of worker sockets."};
+            }
+
+            for (const std::string& socket : split(argv[++i], ",")) {
+                if (!socket.empty()) {
+                    options.coordinatedWorkers.emplace_back(socket);
+                }
+            }
+        } else if (arg == "--fetch-catalog") {
+            if (i + 1 >= argc) {
+                throw std::runtime_error{"--fetch-catalog requires a term (e.g. \"2025 Fall De Anza\")."};
+            }
+
+            options.catalogTerm = argv[++i];
+        } else {
+            throw std::runtime_error{"Unknown argument: " + std::string{arg}};
+        }
+    }
+
+    if (options.worker && !options.controlSocket) {
+        throw std::runtime_error{"--worker requires --control-socket so that the coordinator can reach it."};
+    }
+
+    if (!options.coordinatedWorkers.empty() && (options.worker || options.role)) {
+        throw std::runtime_error{"--coordinator can't be combined with --worker or --role."};
+    }
+
+    return options;
 }
 } // namespace
 
-int main() {
-    setupDate();
+int main(int argc, char* argv[]) {
     setupLogging();
     setupSignalHandlers();
 
+    CommandLineOptions options;
+    try {
+        options = parseCommandLine(argc, argv);
+    } catch (const std::exception& e) {
+        spdlog::get("console")->error(e.what());
+        return 1;
+    }
+
+    if (options.stateDirectory) {
+        setStateDirectory(*options.stateDirectory);
+    }
+
+    if (options.catalogTerm) {
+        return fetchCatalog(*options.catalogTerm);
+    }
+
     checkVersion();
 
     spdlog::get("console")->warn("DARE no longer works due to unsolvable issues with authentication.");
     spdlog::get("console")->warn("The program will still attempt to run, but will fail to authenticate.");
     spdlog::get("console")->warn("Check the GitHub repo for additional details.");
 
-    g_taskManager = std::make_unique<TaskManager>();
+    if (!options.coordinatedWorkers.empty()) {
+        g_coordinator = std::make_unique<Coordinator>(options.coordinatedWorkers);
+        if (options.controlSocket) {
+            g_coordinator->enableControlSocket(*options.controlSocket);
+        }
+
+        g_coordinator->start();
+        return 0;
+    }
+
+    g_taskManager = std::make_unique<TaskManager>(!options.worker);
+    if (options.controlSocket) {
+        g_taskManager->enableControlSocket(*options.controlSocket);
+    }
+
+    if (options.role) {
+        g_taskManager->enableFailover(*options.role);
+    }
+
     g_taskManager->start();
+
+    EventLog::instance().stop();
+
+    // Give failure notifications from tasks that just stopped a chance to go out
+    static constexpr std::chrono::seconds NOTIFICATION_FLUSH_TIMEOUT{5};
+    DiscordNotifier::instance().shutdown(NOTIFICATION_FLUSH_TIMEOUT);
 }
\ No newline at end of file
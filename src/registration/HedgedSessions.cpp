@@ -0,0 +1,358 @@
+#include "registration/HedgedSessions.h"
+#include "auth/Authentication.h"
+#include "data/Links.h"
+#include "registration/RegistrationUtil.h"
+#include "task/Task.h"
+#include "util/Requests.h"
+#include "util/Utility.h"
+
+#include <fmt/format.h>
+
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+struct HedgedSessions::Round {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::size_t undecided = 0; // Hedges still adding to their carts
+    std::size_t contenders = 0; // Sessions that sent the batch
+    std::size_t finished = 0;
+    bool closed = false; // No more batches go out
+    std::vector<std::pair<std::size_t, std::string>> confirmed; // By session (0 is the main one), in arrival order
+    std::string mainResponse; // Unless it confirmed the batch
+    std::exception_ptr mainFailure;
+};
+
+namespace {
+bool confirmsBatch(const std::string_view response) {
+    const rapidjson::Document json = parseJsonResponse(response);
+    return json.IsObject() && json.HasMember("success") && json["success"].IsBool() && json["success"].GetBool();
+}
+
+std::string describeSession(const std::size_t session) {
+    return session == 0 ? "the main session" : fmt::format("hedged session {}", session);
+}
+} // namespace
+
+HedgedSessions::~HedgedSessions() {
+    settle();
+
+    for (const auto& hedge : m_hedges) {
+        if (hedge->preparing.valid()) {
+            hedge->preparing.wait();
+        }
+    }
+}
+
+bool HedgedSessions::empty() const noexcept {
+    return m_hedges.empty();
+}
+
+void HedgedSessions::prepare(Task& task) {
+    startPreparing(task);
+
+    for (const auto& hedge : m_hedges) {
+        if (hedge->preparing.valid()) {
+            hedge->preparing.wait();
+        }
+    }
+
+    task.scheduler.throwIfStopped();
+}
+
+void HedgedSessions::startPreparing(Task& task) {
+    settle();
+
+    while (m_hedges.size() < static_cast<std::size_t>(task.config.hedgedSessions)) {
+        m_hedges.push_back(std::make_unique<Hedge>());
+    }
+
+    for (std::size_t i = 0; i < m_hedges.size(); ++i) {
+        Hedge& hedge = *m_hedges[i];
+        if (hedge.preparing.valid() && hedge.preparing.wait_for(std::chrono::seconds{0}) != std::future_status::ready) {
+            continue; // Still at it from the last call
+        }
+
+        hedge.preparing = std::async(std::launch::async, [&task, &hedge, i] {
+            LatencyMode::releaseCurrentThread();
+            try {
+                authenticate(task, hedge.sessionManager);
+
+                cpr::Session& session = hedge.sessionManager.getSession();
+                visitRegistrationDashboard(session);
+                registrationTermSelect(session);
+                hedge.termSelectedFor = hedge.sessionManager.uniqueSessionId;
+                hedge.requestTemplates.prepare(task.config.termCode, hedge.sessionManager.uniqueSessionId);
+                hedge.signedIn = true;
+            } catch (const std::exception& e) {
+                hedge.signedIn = false;
+                task.logger.warn("Hedged session {} couldn't sign in - {}.", i + 1, e.what());
+            }
+        });
+    }
+}
+
+bool HedgedSessions::isReady(Hedge& hedge) {
+    if (hedge.preparing.valid()) {
+        if (hedge.preparing.wait_for(std::chrono::seconds{0}) != std::future_status::ready) {
+            return false;
+        }
+
+        hedge.preparing.get();
+    }
+
+    return hedge.signedIn;
+}
+
+bool HedgedSessions::addToCart(Task& task, Hedge& hedge, const std::atomic<bool>& cancelled,
+        const CartRequest& request) {
+    using namespace std::chrono;
+
+    // Same as the main session's check
+    static constexpr seconds AUTHENTICATION_TRUSTED_FOR{60};
+
+    SessionManager& sessionManager = hedge.sessionManager;
+    NavigationState& navigation = sessionManager.navigation;
+    if (!navigation.verifiedAt || steady_clock::now() - *navigation.verifiedAt >= AUTHENTICATION_TRUSTED_FOR) {
+        authenticate(task, sessionManager);
+    }
+
+    cpr::Session& session = sessionManager.getSession();
+    if (navigation.confirmedTerm != task.config.termCode) {
+        // Signing in again gives the session a new unique session ID
+        if (hedge.termSelectedFor != sessionManager.uniqueSessionId) {
+            visitRegistrationDashboard(session);
+            registrationTermSelect(session);
+            hedge.termSelectedFor = sessionManager.uniqueSessionId;
+            hedge.requestTemplates.prepare(task.config.termCode, sessionManager.uniqueSessionId);
+        }
+
+        const auto giveUpAt = steady_clock::now() + seconds{task.config.openProbeWindowSeconds};
+        while (!confirmTermIfOpen(session, sessionManager.uniqueSessionId, task.config.termCode)) {
+            if (cancelled || steady_clock::now() >= giveUpAt) {
+                return false;
+            }
+
+            std::this_thread::sleep_for(milliseconds{task.config.openProbeIntervalMs});
+        }
+
+        navigation.confirmedTerm = task.config.termCode;
+    }
+
+    rapidjson::Document oldModel;
+    if (!request.drops.empty()) {
+        oldModel = parseJsonResponse(extractSummaryModels(visitClassRegistration(session)));
+    }
+
+    const cpr::Response response = sendRequest(session, RequestMethod::POST, Link::Reg::ADD_CRN_REG_ITEMS,
+        cpr::Body{request.body});
+    if (cpr::status::is_redirect(response.status_code)) {
+        return false;
+    }
+
+    rapidjson::Document cart = parseJsonResponse(response.text);
+    if (!cart.IsObject() || !cart.HasMember("aaData") || !cart["aaData"].IsArray()) {
+        return false;
+    }
+
+    // Same as addCoursesToBatch and addDropsToBatch on the main session
+    RequestTemplates& requestTemplates = hedge.requestTemplates;
+    requestTemplates.beginBatch();
+    for (auto& course : cart["aaData"].GetArray()) {
+        if (!course["success"].GetBool()) {
+            continue;
+        }
+
+        auto& model = course["model"];
+        if (model["properties"]["registrationActions"].Size() == 3 &&
+                request.waitlistable.contains(model["courseReferenceNumber"].GetString())) {
+            model["selectedAction"].SetString(rapidjson::StringRef("WL"));
+        }
+
+        requestTemplates.appendUpdate(model);
+    }
+
+    if (requestTemplates.getUpdateCount() == 0) {
+        return false;
+    }
+
+    if (oldModel.IsArray()) {
+        for (auto& model : oldModel.GetArray()) {
+            if (request.drops.contains(model["courseReferenceNumber"].GetString())) {
+                model["selectedAction"].SetString(rapidjson::StringRef("DW"));
+                requestTemplates.appendUpdate(model);
+            }
+        }
+    }
+
+    hedge.batch = requestTemplates.finishBatch();
+    return true;
+}
+
+void HedgedSessions::addToCarts(Task& task, const std::string_view cartBody) {
+    settle();
+    m_cancelCarts = std::make_shared<std::atomic<bool>>(false);
+
+    CourseManager& courseManager = task.courseManager;
+    const auto request = std::make_shared<CartRequest>(std::string{cartBody}, StringSet{},
+        courseManager.getDropQueue());
+    for (const std::string& crn : courseManager.getRegistrationQueue()) {
+        if (courseManager.canWaitlistCourse(crn)) {
+            request->waitlistable.insert(crn);
+        }
+    }
+
+    for (std::size_t i = 0; i < m_hedges.size(); ++i) {
+        Hedge& hedge = *m_hedges[i];
+        if (!isReady(hedge)) {
+            continue;
+        }
+
+        hedge.cartAdded = std::async(std::launch::async, [&task, &hedge, i, cancelled = m_cancelCarts, request] {
+            LatencyMode::releaseCurrentThread();
+            try {
+                return addToCart(task, hedge, *cancelled, *request);
+            } catch (const std::exception& e) {
+                hedge.sessionManager.navigation = {};
+                task.logger.debug("Hedged session {} couldn't add to its cart - {}.", i + 1, e.what());
+                return false;
+            }
+        });
+    }
+}
+
+std::vector<std::string> HedgedSessions::sendBatch(Task& task, const std::function<std::string()>& sendMain) {
+    if (m_hedges.empty()) {
+        return {sendMain()};
+    }
+
+    const auto round = std::make_shared<Round>();
+    m_round = round;
+
+    round->contenders = 1;
+    // The main session's send is on the critical path, so unlike the hedges' it keeps latency-critical mode
+    m_inFlight.push_back(std::async(std::launch::async, [round, sendMain] {
+        std::string response;
+        std::exception_ptr failure;
+        try {
+            response = sendMain();
+        } catch (...) {
+            failure = std::current_exception();
+        }
+
+        const bool confirmed = !failure && confirmsBatch(response);
+
+        std::lock_guard lock{round->mutex};
+        if (confirmed) {
+            round->confirmed.emplace_back(0, std::move(response));
+        } else {
+            round->mainResponse = std::move(response);
+            round->mainFailure = failure;
+        }
+
+        ++round->finished;
+        round->cv.notify_all();
+    }));
+
+    for (std::size_t i = 0; i < m_hedges.size(); ++i) {
+        Hedge& hedge = *m_hedges[i];
+        if (!hedge.cartAdded.valid()) {
+            continue;
+        }
+
+        ++round->undecided;
+        m_inFlight.push_back(std::async(std::launch::async, [round, &hedge, session = i + 1,
+                cartAdded = std::move(hedge.cartAdded)]() mutable {
+            LatencyMode::releaseCurrentThread();
+            bool ready = cartAdded.get();
+            {
+                std::lock_guard lock{round->mutex};
+                --round->undecided;
+                ready = ready && !round->closed;
+                if (!ready) {
+                    round->cv.notify_all();
+                    return;
+                }
+
+                ++round->contenders;
+            }
+
+            std::string response;
+            cpr::Session& hedgeSession = hedge.sessionManager.getSession();
+            hedgeSession.SetHeader(getJsonHeaders());
+            try {
+                response = sendRequest(hedgeSession, RequestMethod::POST, Link::Reg::BATCH,
+                    cpr::BodyView{hedge.batch}).text;
+            } catch (const std::exception&) {
+                hedge.sessionManager.navigation = {};
+            }
+            hedgeSession.SetHeader(getDefaultHeaders());
+
+            const bool confirmed = !response.empty() && confirmsBatch(response);
+
+            std::lock_guard lock{round->mutex};
+            if (confirmed) {
+                round->confirmed.emplace_back(session, std::move(response));
+            }
+
+            ++round->finished;
+            round->cv.notify_all();
+        }));
+    }
+
+    // Without a confirmation, a hedge still adding to its cart could be the one to get it
+    std::unique_lock lock{round->mutex};
+    round->cv.wait(lock, [&] {
+        return !round->confirmed.empty() || (round->undecided == 0 && round->finished == round->contenders);
+    });
+
+    // Hedges that haven't sent yet are too late to matter, so only responses already on their way are waited for
+    round->closed = true;
+    *m_cancelCarts = true;
+    round->cv.wait_for(lock, RECONCILE_TIMEOUT, [&] { return round->finished == round->contenders; });
+
+    if (round->confirmed.empty()) {
+        if (round->mainFailure) {
+            std::rethrow_exception(round->mainFailure);
+        }
+
+        return {std::move(round->mainResponse)};
+    }
+
+    task.logger.info("The batch was confirmed first on {} ({} of {} sessions confirmed it).",
+        describeSession(round->confirmed.front().first), round->confirmed.size(), round->contenders);
+
+    if (const std::size_t unanswered = round->contenders - round->finished; unanswered > 0) {
+        task.logger.warn("{} session{} didn't answer the batch in time, so courses only they got aren't counted yet.",
+            unanswered, determinePlural(unanswered));
+    }
+
+    std::vector<std::string> responses;
+    responses.reserve(round->confirmed.size());
+    for (auto& [session, response] : round->confirmed) {
+        responses.push_back(std::move(response));
+    }
+
+    return responses;
+}
+
+void HedgedSessions::settle() {
+    *m_cancelCarts = true;
+    if (m_round) {
+        std::lock_guard lock{m_round->mutex};
+        m_round->closed = true;
+    }
+
+    m_inFlight.clear();
+    for (const auto& hedge : m_hedges) {
+        if (hedge->cartAdded.valid()) {
+            hedge->cartAdded.wait();
+            hedge->cartAdded = {};
+        }
+    }
+
+    m_round.reset();
+}
@@ -0,0 +1,90 @@
+#ifndef HEDGEDSESSIONS_H
+#define HEDGEDSESSIONS_H
+
+#include "registration/RequestTemplates.h"
+#include "task/SessionManager.h"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct Task;
+
+// Extra sessions (hedged_sessions), each signed in on its own with its own cookies, connection, and unique session ID,
+// so that one slow connection or server node during registration doesn't cost the seat.
+//
+// Every registration adds the CRNs to each hedge's cart alongside the main session's, and each hedge builds its own
+// batch from the models in its own cart, so that nothing one session's cart returned is sent on another. The batches
+// go out on all sessions at once. The first response that confirms its batch decides the results, and the others are
+// only used to fill in courses it didn't get (see reviewBatchResponses). Hedges only visit the class registration
+// page when there are drops, whose models come from it, and a hedge whose cart isn't ready by the time the batch is
+// confirmed just sits it out.
+class HedgedSessions {
+public:
+    HedgedSessions() = default;
+    ~HedgedSessions(); // Waits for anything still in flight
+
+    HedgedSessions(const HedgedSessions&) = delete;
+    HedgedSessions& operator=(const HedgedSessions&) = delete;
+
+    [[nodiscard]] bool empty() const noexcept;
+
+    // Signs in every hedge that isn't already (all at once) and selects the term on them, so that registration only
+    // has to confirm it. A hedge that fails is left out until the next call.
+    void prepare(Task& task);
+    // The same without waiting, for right before registration, when one slow sign-in mustn't hold up the main session.
+    // Hedges sit registration out until they're ready, and one still signing in from an earlier call is left to it.
+    void startPreparing(Task& task);
+
+    // Starts adding the CRNs to every hedge's cart and building its batch in the background, waiting for registration
+    // to open first if the hedge finds it closed. Takes what it needs from the course manager up front.
+    void addToCarts(Task& task, std::string_view cartBody);
+
+    // Sends the batch on the main session (through sendMain) and on every hedge as soon as its own batch is ready.
+    // Once one confirms it, hedges that haven't sent anything yet don't, and the responses that confirmed it are
+    // returned, the first one first, once the other sessions that sent have come back or RECONCILE_TIMEOUT has
+    // passed. If none confirmed it, returns the main session's response or rethrows its failure. With no hedges, only
+    // sends on the main session.
+    [[nodiscard]] std::vector<std::string> sendBatch(Task& task, const std::function<std::string()>& sendMain);
+
+    // Cancels cart adds that never got a batch and waits for everything still in flight
+    void settle();
+
+private:
+    static constexpr std::chrono::seconds RECONCILE_TIMEOUT{5};
+
+    struct Hedge {
+        SessionManager sessionManager;
+        RequestTemplates requestTemplates;
+        std::string termSelectedFor; // The unique session ID the term was last selected with
+        bool signedIn = false;
+        std::future<void> preparing; // Signing in, which signedIn is only up to date after
+        std::future<bool> cartAdded; // Whether `batch` is ready
+        std::string_view batch; // In requestTemplates
+    };
+
+    // What a hedge needs to build its batch, copied so that it doesn't touch the course manager
+    struct CartRequest {
+        std::string body;
+        StringSet waitlistable; // CRNs in the cart that can be waitlisted
+        StringSet drops;
+    };
+
+    struct Round;
+
+    // Whether the hedge has finished signing in and succeeded
+    static bool isReady(Hedge& hedge);
+    static bool addToCart(Task& task, Hedge& hedge, const std::atomic<bool>& cancelled, const CartRequest& request);
+
+    std::vector<std::unique_ptr<Hedge>> m_hedges;
+    std::shared_ptr<std::atomic<bool>> m_cancelCarts = std::make_shared<std::atomic<bool>>(false);
+    std::shared_ptr<Round> m_round; // Shared with the sends, which can outlive sendBatch()
+    std::vector<std::future<void>> m_inFlight;
+};
+
+#endif // HEDGEDSESSIONS_H
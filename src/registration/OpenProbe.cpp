@@ -0,0 +1,90 @@
+#include "registration/OpenProbe.h"
+#include "registration/RegistrationUtil.h"
+#include "task/Task.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+
+namespace {
+// Probes that failed in a row without any response in between, after which the last failure is rethrown. Something
+// like an expired session or a portal error page would otherwise be retried forever without a word.
+constexpr int MAX_CONSECUTIVE_FAILURES = 10;
+
+// Shared with the probes, which can outlive the run that sent them
+struct ProbeResults {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool open = false;
+    int responses = 0;
+    int failures = 0;
+    int consecutiveFailures = 0;
+    std::exception_ptr lastFailure;
+};
+} // namespace
+
+bool OpenProbe::run(Task& task, const std::chrono::milliseconds interval,
+        const std::chrono::steady_clock::time_point until) {
+    using namespace std::chrono;
+    const auto sessions = static_cast<std::size_t>(task.config.openProbeSessions);
+
+    m_inFlight.clear(); // Waits for any left over from the last run
+    m_inFlight.resize(sessions);
+    const auto results = std::make_shared<ProbeResults>();
+
+    std::size_t next = 0;
+    auto nextProbe = steady_clock::now();
+    while (true) {
+        task.scheduler.throwIfStopped();
+
+        // A session that's still waiting on its last probe sits this turn out
+        std::future<void>& slot = m_inFlight[next];
+        if (!slot.valid() || slot.wait_for(0s) == std::future_status::ready) {
+            slot = std::async(std::launch::async, [session = task.sessionManager.getProbeSession(next),
+                    sessionId = task.sessionManager.uniqueSessionId, termCode = task.config.termCode, results] {
+                LatencyMode::releaseCurrentThread();
+
+                bool open = false;
+                try {
+                    open = confirmTermIfOpen(*session, sessionId, termCode);
+                } catch (const std::exception&) {
+                    std::lock_guard lock{results->mutex};
+                    ++results->failures;
+                    ++results->consecutiveFailures;
+                    results->lastFailure = std::current_exception();
+                    results->cv.notify_all();
+                    return;
+                }
+
+                std::lock_guard lock{results->mutex};
+                ++results->responses;
+                results->consecutiveFailures = 0;
+                if (open && !results->open) {
+                    results->open = true;
+                    results->cv.notify_all();
+                }
+            });
+        }
+
+        next = (next + 1) % sessions;
+        nextProbe += interval;
+
+        std::unique_lock lock{results->mutex};
+        results->cv.wait_until(lock, std::min(nextProbe, until), [&] {
+            return results->open || results->consecutiveFailures >= MAX_CONSECUTIVE_FAILURES;
+        });
+
+        const bool open = results->open;
+        if (!open && results->consecutiveFailures >= MAX_CONSECUTIVE_FAILURES) {
+            task.logger.warn("Open probes failed {} times in a row.", results->consecutiveFailures);
+            std::rethrow_exception(results->lastFailure);
+        }
+
+        if (open || steady_clock::now() >= until) {
+            task.logger.debug("Open probes: {} answered, {} failed.", results->responses, results->failures);
+            return open;
+        }
+    }
+}
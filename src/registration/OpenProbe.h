@@ -0,0 +1,32 @@
+#ifndef OPENPROBE_H
+#define OPENPROBE_H
+
+#include <chrono>
+#include <future>
+#include <vector>
+
+struct Task;
+
+// Watches for registration to open by confirming the term over several probe sessions in turn, so that a probe goes
+// out every interval even when each one takes longer than that to come back.
+//
+// Only the term confirmation is repeated. Its response is the one that says whether the student can register, and
+// the dashboard and term selection visits before it only need to happen once.
+class OpenProbe {
+public:
+    OpenProbe() = default;
+    ~OpenProbe() = default; // Waits for probes still in flight
+
+    OpenProbe(const OpenProbe&) = delete;
+    OpenProbe& operator=(const OpenProbe&) = delete;
+
+    // Returns true as soon as a probe finds registration open, or false once `until` passes without one. Probes still
+    // in flight are left to finish in the background, so registration can start on the main session right away.
+    // Rethrows the last probe's error if too many fail in a row without a response.
+    bool run(Task& task, std::chrono::milliseconds interval, std::chrono::steady_clock::time_point until);
+
+private:
+    std::vector<std::future<void>> m_inFlight; // One per probe session
+};
+
+#endif // OPENPROBE_H
@@ -0,0 +1,172 @@
+#include "registration/OpeningBurst.h"
+#include "data/Links.h"
+#include "registration/RegistrationUtil.h"
+#include "task/Task.h"
+#include "util/Requests.h"
+#include "util/Utility.h"
+
+#include <fmt/format.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+struct OpeningBurst::State {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<Shot> shots;
+    std::size_t finished = 0;
+    bool termConfirmed = false;
+    bool landed = false;
+    std::string cart; // The winning shot's response
+};
+
+namespace {
+std::string_view describe(const OpeningBurst::Outcome outcome) {
+    switch (outcome) {
+        case OpeningBurst::Outcome::Pending:
+            return "never finished";
+        case OpeningBurst::Outcome::Skipped:
+            return "skipped";
+        case OpeningBurst::Outcome::NotOpen:
+            return "registration not open";
+        case OpeningBurst::Outcome::Rejected:
+            return "cart rejected";
+        case OpeningBurst::Outcome::Failed:
+            return "request failed";
+        case OpeningBurst::Outcome::Superseded:
+            return "added to cart after another shot";
+        case OpeningBurst::Outcome::Landed:
+            return "added to cart";
+    }
+
+    std::unreachable();
+}
+} // namespace
+
+void OpeningBurst::arm() noexcept {
+    m_armed = true;
+}
+
+bool OpeningBurst::isArmed() const noexcept {
+    return m_armed;
+}
+
+std::optional<std::string> OpeningBurst::fire(Task& task, const std::string_view cartBody) {
+    using namespace std::chrono;
+    static constexpr milliseconds STOP_CHECK_INTERVAL{100};
+
+    m_armed = false;
+    m_inFlight.clear(); // Waits for any left over from a previous burst
+
+    const auto openingTime = task.scheduler.getLocalOpeningTime();
+    const auto state = std::make_shared<State>();
+    for (const int offset : task.config.openingBurstMs) {
+        state->shots.push_back(Shot{.offset = milliseconds{offset}});
+    }
+    m_state = state;
+
+    for (std::size_t i = 0; i < state->shots.size(); ++i) {
+        m_inFlight.push_back(std::async(std::launch::async, [state, i, openingTime,
+                session = task.sessionManager.getProbeSession(i), sessionId = task.sessionManager.uniqueSessionId,
+                termCode = task.config.termCode, body = std::string{cartBody}] {
+            std::this_thread::sleep_until(openingTime + state->shots[i].offset);
+
+            bool confirmTerm = false;
+            {
+                std::lock_guard lock{state->mutex};
+                if (state->landed) {
+                    state->shots[i].outcome = Outcome::Skipped;
+                    ++state->finished;
+                    state->cv.notify_all();
+                    return;
+                }
+
+                confirmTerm = !state->termConfirmed;
+            }
+
+            const auto sent = system_clock::now();
+            Outcome outcome = Outcome::Rejected;
+            std::string cart;
+            try {
+                if (confirmTerm && !confirmTermIfOpen(*session, sessionId, termCode)) {
+                    outcome = Outcome::NotOpen;
+                } else {
+                    if (confirmTerm) {
+                        std::lock_guard lock{state->mutex};
+                        state->termConfirmed = true;
+                    }
+
+                    cpr::Response response = sendRequest(*session, RequestMethod::POST,
+                        Link::Reg::ADD_CRN_REG_ITEMS, cpr::Body{body});
+                    if (isCartResponse(response)) {
+                        outcome = Outcome::Landed;
+                        cart = std::move(response.text);
+                    }
+                }
+            } catch (const std::exception&) {
+                outcome = Outcome::Failed;
+            }
+
+            std::lock_guard lock{state->mutex};
+            if (outcome == Outcome::Landed) {
+                if (state->landed) {
+                    outcome = Outcome::Superseded;
+                } else {
+                    state->landed = true;
+                    state->cart = std::move(cart);
+                }
+            }
+
+            Shot& shot = state->shots[i];
+            shot.sentAt = duration_cast<microseconds>(sent - openingTime);
+            shot.roundTrip = duration_cast<milliseconds>(system_clock::now() - sent);
+            shot.outcome = outcome;
+            ++state->finished;
+            state->cv.notify_all();
+        }));
+    }
+
+    std::unique_lock lock{state->mutex};
+    while (!state->cv.wait_for(lock, STOP_CHECK_INTERVAL, [&] {
+            return state->landed || state->finished == state->shots.size();
+        })) {
+        task.scheduler.throwIfStopped();
+    }
+
+    if (!state->landed) {
+        return std::nullopt;
+    }
+
+    return std::move(state->cart);
+}
+
+bool OpeningBurst::report(const Task& task) {
+    const bool unfired = std::exchange(m_armed, false);
+    if (!m_state) {
+        return unfired;
+    }
+
+    m_inFlight.clear();
+    const auto state = std::exchange(m_state, nullptr);
+
+    for (const Shot& shot : state->shots) {
+        if (shot.outcome == Outcome::Skipped || shot.outcome == Outcome::Pending) {
+            task.logger.info("Opening shot at {:+}ms: {}.", shot.offset.count(), describe(shot.outcome));
+            continue;
+        }
+
+        task.logger.info("Opening shot at {:+}ms: sent at {:+.1f}ms, {} after {}ms.", shot.offset.count(),
+            std::chrono::duration<double, std::milli>{shot.sentAt}.count(), describe(shot.outcome),
+            shot.roundTrip.count());
+        recordDuration(task, fmt::format("Opening shot at {:+}ms", shot.offset.count()), shot.roundTrip);
+
+        // Kept apart by mode, so its effect on how late the shots go out shows up side by side
+        const auto lateness = std::chrono::round<std::chrono::milliseconds>(shot.sentAt) - shot.offset;
+        recordDuration(task, task.latencyMode.isActive() ? "Opening shot lateness (latency-critical mode)"
+            : "Opening shot lateness", lateness);
+    }
+
+    return unfired;
+}
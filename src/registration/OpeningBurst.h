@@ -0,0 +1,67 @@
+#ifndef OPENINGBURST_H
+#define OPENINGBURST_H
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct Task;
+
+// Adds the registration queue to the cart with a series of shots at planned offsets from the registration time
+// (opening_burst_ms), so that one of them lands right after the portal opens registration, even if that's a little
+// off from the time it gives.
+//
+// Each shot runs on its own probe session: it confirms the term (unless an earlier shot already has) and, if
+// registration is open, adds the CRNs to the cart. The first shot to get a cart back wins, and shots that aren't due
+// yet are skipped, so only one batch is ever built from the burst.
+class OpeningBurst {
+public:
+    enum class Outcome {
+        Pending,
+        Skipped, // Another shot had already landed
+        NotOpen,
+        Rejected, // Registration was open, but the cart wasn't
+        Failed,
+        Superseded, // Added to the cart after another shot had already landed
+        Landed
+    };
+
+    struct Shot {
+        std::chrono::milliseconds offset; // Planned, from the registration time
+        std::chrono::microseconds sentAt{}; // Actual, from the registration time
+        std::chrono::milliseconds roundTrip{};
+        Outcome outcome = Outcome::Pending;
+    };
+
+    OpeningBurst() = default;
+    ~OpeningBurst() = default; // Waits for shots still in flight
+
+    OpeningBurst(const OpeningBurst&) = delete;
+    OpeningBurst& operator=(const OpeningBurst&) = delete;
+
+    // Makes the next cart add go through fire()
+    void arm() noexcept;
+    [[nodiscard]] bool isArmed() const noexcept;
+
+    // Returns the winning shot's cart response as soon as one lands, or nothing once every shot has missed. Shots
+    // still in flight are left to finish in the background.
+    [[nodiscard]] std::optional<std::string> fire(Task& task, std::string_view cartBody);
+
+    // Logs and records the timing and outcome of every shot, once they've all finished. Only the first registration
+    // gets the burst, so this also disarms one that never fired, e.g. because there was nothing to add. Returns true
+    // in that case, since nothing has confirmed that registration opened.
+    [[nodiscard]] bool report(const Task& task);
+
+private:
+    struct State;
+
+    bool m_armed = false;
+    std::shared_ptr<State> m_state; // Shared with the shots, which can outlive fire()
+    std::vector<std::future<void>> m_inFlight;
+};
+
+#endif // OPENINGBURST_H
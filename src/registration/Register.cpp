@@ -2,28 +2,43 @@
 #include "auth/Authentication.h"
 #include "data/Enrollment.h"
 #include "data/Links.h"
+#include "data/SeatHistory.h"
+#include "events/SeatEventBus.h"
 #include "registration/RegistrationUtil.h"
+#include "registration/StageGraph.h"
+#include "task/PollingPlanner.h"
 #include "task/Task.h"
+#include "task/TaskCheckpoint.h"
+#include "util/AllocationCounter.h"
 #include "util/Exceptions.h"
 #include "util/Requests.h"
 #include "util/Utility.h"
 
 #include <fmt/format.h>
+#include <fmt/ranges.h>
 #include <rapidjson/document.h>
-#include <rapidjson/writer.h>
 
 #include <algorithm>
 #include <expected>
+#include <functional>
+#include <iterator>
+#include <mutex>
 #include <optional>
 #include <random>
 #include <ranges>
-#include <unordered_set>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace {
 using CrnRef = std::reference_wrapper<CRN>;
 using AddDropPair = std::pair<CrnRef, std::optional<std::string>>;
 
+// The portal didn't accept the cart request, most likely because the session isn't where the navigation state says
+struct NavigationRejected final : std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
 void notifyResults(Task& task) {
     for (const auto& [title, message] : task.courseManager.getNotificationQueue()) {
         sendDiscordNotification(task, title, message);
@@ -56,34 +71,44 @@ bool ineligibleToRegister(const std::string_view regMessage) {
     });
 }
 
-std::string getDescription(const std::string_view statusDescription) {
+std::string_view getDescription(const std::string_view statusDescription) {
     if (statusDescription == "Deleted") {
-        return std::string{"Dropped"};
+        return "Dropped";
     }
 
-    return std::string{statusDescription};
+    return statusDescription;
+}
+
+// Responses are parsed in place, so this points into the response buffer
+std::string_view getView(const rapidjson::Value& value) {
+    return {value.GetString(), value.GetStringLength()};
+}
+
+bool isSuccessfulStatus(const std::string_view status) {
+    return status == "Registered" || status == "Waitlisted" || status == "Dropped";
+}
+
+bool updateSucceeded(const rapidjson::Value& update) {
+    return isSuccessfulStatus(getDescription(getView(update["statusDescription"])));
 }
 
 void processUpdate(Task& task, const rapidjson::Value& update) {
-    std::string crn{update["courseReferenceNumber"].GetString(), update["courseReferenceNumber"].GetStringLength()};
+    const std::string_view crn = getView(update["courseReferenceNumber"]);
 
     if (!task.courseManager.getRegistrationQueue().contains(crn) && !task.courseManager.getDropQueue().contains(crn)) {
         return;
     }
 
-    std::string courseCode = formatCourseCode(
-        std::string{update["subject"].GetString(), update["subject"].GetStringLength()},
-        std::string{update["courseDisplay"].GetString(), update["courseDisplay"].GetStringLength()}
-    );
+    std::string courseCode = formatCourseCode(getView(update["subject"]), getView(update["courseDisplay"]));
     std::string message = fmt::format("[{}] {} - ", crn, courseCode);
 
-    if (const std::string status = getDescription(update["statusDescription"].GetString());
-            status == "Registered" || status == "Waitlisted" || status == "Dropped") {
-        message += "Successfully " + status;
-        task.courseManager.removeCourse(crn);
+    if (const std::string_view status = getDescription(getView(update["statusDescription"]));
+            isSuccessfulStatus(status)) {
+        fmt::format_to(std::back_inserter(message), "Successfully {}", status);
+        task.courseManager.completeCourse(crn);
     } else if (status == "Errors Preventing Registration") {
-        const auto& error = update["messages"][0]["message"]; // First one is usually the most important
-        const std::string_view errorMessage{error.GetString(), error.GetStringLength()};
+        // First one is usually the most important
+        const std::string_view errorMessage = getView(update["messages"][0]["message"]);
 
         if (ineligibleToRegister(errorMessage)) {
             task.courseManager.removeCourse(crn);
@@ -97,42 +122,102 @@ void processUpdate(Task& task, const rapidjson::Value& update) {
     task.courseManager.enqueueNotification(std::move(courseCode), std::move(message));
 }
 
-void reviewBatchResponse(Task& task, const std::string_view response) {
+bool isWellFormedUpdate(const rapidjson::Value& update) {
+    static constexpr const char* STRING_FIELDS[] = {"courseReferenceNumber", "statusDescription", "subject",
+        "courseDisplay"};
+
+    return update.IsObject() && std::ranges::all_of(STRING_FIELDS, [&](const char* name) {
+        return update.HasMember(name) && update[name].IsString();
+    });
+}
+
+// One update per CRN across every response, since each session's batch is built from its own cart and can include
+// CRNs the others' didn't. A successful update wins over a failed one, and otherwise the earliest response's does.
+// Responses after the first only fill in, so ones that are shaped differently are skipped rather than trusted.
+std::vector<const rapidjson::Value*> collectUpdates(const std::vector<rapidjson::Document>& responses) {
+    std::vector<const rapidjson::Value*> updates;
+    std::unordered_map<std::string_view, std::size_t> indexByCrn;
+
+    for (const rapidjson::Document& response : responses) {
+        const bool first = &response == &responses.front();
+        if (!first && (!response.IsObject() || !response.HasMember("data") || !response["data"].IsObject() ||
+                !response["data"].HasMember("update") || !response["data"]["update"].IsArray())) {
+            continue;
+        }
+
+        for (const auto& update : response["data"]["update"].GetArray()) {
+            if (!first && !isWellFormedUpdate(update)) {
+                continue;
+            }
+
+            const auto [it, inserted] = indexByCrn.try_emplace(getView(update["courseReferenceNumber"]),
+                updates.size());
+            if (inserted) {
+                updates.push_back(&update);
+            } else if (!updateSucceeded(*updates[it->second]) && updateSucceeded(update)) {
+                updates[it->second] = &update;
+            }
+        }
+    }
+
+    return updates;
+}
+
+// Takes the responses from HedgedSessions::sendBatch, where any after the first are from other sessions that also
+// confirmed the batch. Parses them in place, so they're left modified.
+void reviewBatchResponses(Task& task, std::vector<std::string>& responses) {
     task.scheduler.throwIfStopped();
 
-    const rapidjson::Document batchResponse = parseJsonResponse(response);
+    std::vector<rapidjson::Document> batchResponses;
+    batchResponses.reserve(responses.size());
+    for (std::string& response : responses) {
+        batchResponses.push_back(parseJsonInsitu(response.data(), &task.courseManager.getAllocator()));
+    }
+
+    const rapidjson::Document& batchResponse = batchResponses.front();
     if (!batchResponse.HasMember("success") || !batchResponse["success"].GetBool()) {
         throw std::runtime_error{"Batch response was unsuccessful."};
     }
 
-    for (const auto& update : batchResponse["data"]["update"].GetArray()) {
-        processUpdate(task, update);
+    for (const rapidjson::Value* update : collectUpdates(batchResponses)) {
+        processUpdate(task, *update);
     }
 
     task.courseManager.clearQueues();
     task.courseManager.getOldModel().Clear();
+    task.courseManager.getModelAllocator().Clear();
     task.courseManager.getAllocator().Clear();
+    task.sessionManager.navigation.modelFresh = false;
 }
 
-std::string sendBatch(const Task& task, const std::string_view batch) {
+// Sends on the task's hedged sessions too, if it has any. Returns the responses the same way.
+std::vector<std::string> sendBatch(Task& task, const std::string_view batch) {
     task.scheduler.throwIfStopped();
 
-    const auto startTime = std::chrono::steady_clock::now();
+    // The standby takes over after a missed heartbeat, which doesn't stop this instance on its own right away
+    if (!task.confirmActive()) {
+        task.logger.error("Another instance took over. Not sending the registration request.");
+        throw TaskCancelled{};
+    }
 
-    cpr::Session& session = task.sessionManager.getSession();
-    session.SetHeader(getJsonHeaders());
+    return task.hedges.sendBatch(task, [&task, batch] {
+        const auto startTime = std::chrono::steady_clock::now();
 
-    std::string respText = sendRequest(session, RequestMethod::POST, Link::Reg::BATCH, cpr::BodyView{batch}).text;
+        cpr::Session& session = task.sessionManager.getSession();
+        session.SetHeader(getJsonHeaders());
 
-    session.SetHeader(getDefaultHeaders());
+        std::string respText = sendRequest(session, RequestMethod::POST, Link::Reg::BATCH, cpr::BodyView{batch}).text;
 
-    task.logger.info("Sent registration request.");
-    logDuration(task.logger, startTime, "Sending batch");
+        session.SetHeader(getDefaultHeaders());
 
-    return respText;
+        task.logger.info("Sent registration request.");
+        logDuration(task, startTime, "Sending batch");
+
+        return respText;
+    });
 }
 
-void addDropsToBatch(Task& task, rapidjson::Document& batch) {
+void addDropsToBatch(Task& task) {
     task.scheduler.throwIfStopped();
 
     std::vector<std::string> dropsToRemove;
@@ -150,8 +235,8 @@ void addDropsToBatch(Task& task, rapidjson::Document& batch) {
             // When we're currently registered for a course, the only actions we have are:
             // - "DW" (***Web Dropped***), and
             // - "null" (None).
-            model["selectedAction"].SetString("DW", batch.GetAllocator());
-            batch["update"].PushBack(model, batch.GetAllocator());
+            model["selectedAction"].SetString(rapidjson::StringRef("DW"));
+            task.requestTemplates.appendUpdate(model);
             break;
         }
 
@@ -167,17 +252,17 @@ void addDropsToBatch(Task& task, rapidjson::Document& batch) {
 }
 
 void handleFailedAdd(Task& task, const rapidjson::Value& val) {
-    const std::string crn{val["courseReferenceNumber"].GetString(), val["courseReferenceNumber"].GetStringLength()};
+    const std::string_view crn = getView(val["courseReferenceNumber"]);
 
     task.courseManager.removeCourse(crn);
     task.courseManager.dequeueCRN(crn);
 
-    std::string message = fmt::format("[{}] Error adding course: {}", crn, val["message"].GetString());
+    std::string message = fmt::format("[{}] Error adding course: {}", crn, getView(val["message"]));
     task.logger.error(message);
     task.courseManager.enqueueNotification("Error Adding Course", std::move(message));
 }
 
-void addCoursesToBatch(Task& task, rapidjson::Document& cart, rapidjson::Document& batch) {
+void addCoursesToBatch(Task& task, rapidjson::Document& cart) {
     for (auto& course : cart["aaData"].GetArray()) {
         if (!course["success"].GetBool()) {
             handleFailedAdd(task, course);
@@ -192,81 +277,178 @@ void addCoursesToBatch(Task& task, rapidjson::Document& cart, rapidjson::Documen
         auto& model = course["model"];
         if (model["properties"]["registrationActions"].Size() == 3 &&
             task.courseManager.canWaitlistCourse(model["courseReferenceNumber"].GetString())) {
-            model["selectedAction"].SetString("WL", cart.GetAllocator());
+            model["selectedAction"].SetString(rapidjson::StringRef("WL"));
         }
 
-        batch["update"].PushBack(model, batch.GetAllocator());
+        task.requestTemplates.appendUpdate(model);
     }
 }
 
-rapidjson::Document createBatch(const std::string& sessionId, rapidjson::MemoryPoolAllocator<>* allocator) {
-    rapidjson::Document batch{allocator};
-    batch.SetObject();
+// With `tookShortcuts`, a cart where every CRN failed is treated as the portal rejecting the shortcut rather than
+// every course being unaddable, so that courses aren't removed because of a skipped step.
+//
+// The cart is parsed in place in `buffer`, which has to outlive it.
+rapidjson::Document parseCart(Task& task, const bool tookShortcuts, std::string& buffer) {
+    rapidjson::Document cart = parseJsonInsitu(buffer.data(), &task.courseManager.getAllocator());
+    if (!cart.IsObject() || !cart.HasMember("aaData") || !cart["aaData"].IsArray()) {
+        throw NavigationRejected{"Unexpected response when adding CRNs to cart"};
+    }
+
+    if (tookShortcuts && std::ranges::none_of(cart["aaData"].GetArray(), [](const rapidjson::Value& course) {
+            return course["success"].GetBool();
+        })) {
+        throw NavigationRejected{"Every CRN failed to be added to cart"};
+    }
 
-    batch.AddMember("create", rapidjson::Value{rapidjson::kArrayType}, *allocator);
-    batch.AddMember("destroy", rapidjson::Value{rapidjson::kArrayType}, *allocator);
-    batch.AddMember("uniqueSessionId", rapidjson::Value{}.SetString(sessionId.c_str(), sessionId.size()), *allocator);
-    batch.AddMember("update", rapidjson::Value{rapidjson::kArrayType}, *allocator);
+    task.logger.info("Added CRNs to cart.");
 
-    return batch;
+    return cart;
 }
 
-std::string createCrnString(const std::unordered_set<std::string>& crnList) {
-    std::string crnString;
+// Parses the cart the same way as parseCart
+rapidjson::Document addCrnRegistrationItems(Task& task, const bool tookShortcuts, std::string& buffer) {
+    auto response = sendRequest(task.sessionManager.getSession(), RequestMethod::POST,
+        Link::Reg::ADD_CRN_REG_ITEMS,
+        cpr::BodyView{task.requestTemplates.encodeAddCrns(task.courseManager.getRegistrationQueue())}
+    );
 
-    // crnList is guaranteed to have at least one CRN
-    static constexpr std::size_t CRN_LENGTH = 6; // Includes the comma
-    crnString.reserve(crnList.size() * CRN_LENGTH - 1); // -1 to remove the comma after the last CRN
+    if (cpr::status::is_redirect(response.status_code)) {
+        throw NavigationRejected{"Adding CRNs to cart was redirected"};
+    }
 
-    for (const std::string& crn : crnList) {
-        if (!crnString.empty()) {
-            crnString += ',';
-        }
+    buffer = std::move(response.text);
+    return parseCart(task, tookShortcuts, buffer);
+}
+
+// Falls back to probing and then adding to the cart on the main session if none of the shots land
+rapidjson::Document addCrnsInBurst(Task& task, std::string& buffer) {
+    const std::string_view body = task.requestTemplates.encodeAddCrns(task.courseManager.getRegistrationQueue());
 
-        crnString += crn;
+    if (std::optional<std::string> cart = task.openingBurst.fire(task, body)) {
+        // The shot that landed also confirmed the term
+        task.sessionManager.navigation.confirmedTerm = task.config.termCode;
+
+        buffer = std::move(*cart);
+        return parseCart(task, true, buffer);
     }
 
-    return crnString;
+    task.logger.info("None of the opening shots found registration open.");
+    waitForRegistrationToOpen(task);
+    return addCrnRegistrationItems(task, true, buffer);
 }
 
-rapidjson::Document addCrnRegistrationItems(Task& task) {
-    const auto now = std::chrono::steady_clock::now();
-
-    const auto response = sendRequest(task.sessionManager.getSession(), RequestMethod::POST,
-        Link::Reg::ADD_CRN_REG_ITEMS,
-        cpr::Payload{
-            {"crnList", createCrnString(task.courseManager.getRegistrationQueue())},
-            {"term", task.config.termCode}
+void recordStages(const Task& task, const StageGraph& graph) {
+    std::vector<std::string_view> skipped;
+    for (const StageGraph::Timing& timing : graph.getTimings()) {
+        if (timing.skipped) {
+            skipped.push_back(timing.name);
+            continue;
         }
-    );
 
-    logDuration(task.logger, now, "Adding CRNs to cart");
-    task.logger.info("Added CRNs to cart.");
+        recordDuration(task, timing.name, std::chrono::duration_cast<std::chrono::milliseconds>(
+            timing.end - timing.start));
+    }
+
+    if (!skipped.empty()) {
+        task.logger.debug("Skipped {}.", fmt::join(skipped, ", "));
+    }
 
-    return parseJsonResponse(response.text, &task.courseManager.getAllocator());
+    task.logger.debug("Critical path: {}", graph.describeCriticalPath());
 }
 
-std::expected<std::string, std::string> prepareBatch(Task& task) {
-    task.scheduler.throwIfStopped();
+// Runs the registration stages as a graph:
+//
+//   authentication -> term -> class registration visit -> cart -> batch
+//                          \-> old model refresh (side session) -/
+//
+// Stages the navigation state says are already done are skipped. The class registration page is only visited in
+// line once per confirmed term, since the portal might expect it before the cart. After that it's only fetched
+// again when queued drops need a fresh old model, and then on the side session while the cart is being filled.
+//
+// When the opening burst is armed, its shots confirm the term and fill the cart themselves, and the page is only
+// fetched afterwards for drops, since it isn't there before registration opens.
+//
+// The returned body is only valid until the next batch is prepared.
+std::expected<std::string_view, std::string> prepareBatch(Task& task, const bool allowShortcuts) {
+    // authAjax is checked at most this often while registration keeps the session busy
+    static constexpr std::chrono::seconds AUTHENTICATION_TRUSTED_FOR{60};
 
-    rapidjson::Document crnCart = addCrnRegistrationItems(task);
-    rapidjson::Document batch = createBatch(task.sessionManager.uniqueSessionId, &task.courseManager.getAllocator());
+    task.scheduler.throwIfStopped();
 
-    addCoursesToBatch(task, crnCart, batch);
-    if (batch["update"].Empty()) {
-        return std::expected<std::string, std::string>{std::unexpect, "Added no courses to batch."};
+    NavigationState& navigation = task.sessionManager.navigation;
+    if (!allowShortcuts) {
+        navigation = {};
     }
 
-    addDropsToBatch(task, batch);
-    if (const std::size_t dropQueueSize = task.courseManager.getDropQueue().size(); dropQueueSize > 0) {
-        task.logger.info("Added {} course{} to drop queue.", dropQueueSize, determinePlural(dropQueueSize));
-    }
+    const bool burst = task.openingBurst.isArmed();
+    const bool checkAuthentication = !navigation.verifiedAt ||
+        std::chrono::steady_clock::now() - *navigation.verifiedAt >= AUTHENTICATION_TRUSTED_FOR;
+    const bool confirmTerm = !burst && navigation.confirmedTerm != task.config.termCode;
+    const bool visitClassRegistration = !burst && (confirmTerm || !navigation.visitedClassRegistration);
+    const bool refreshModel = !visitClassRegistration && !navigation.modelFresh &&
+        !task.courseManager.getDropQueue().empty();
+    const bool tookShortcuts = burst || !checkAuthentication || !confirmTerm || !visitClassRegistration;
+
+    std::string cartBuffer;
+    std::optional<rapidjson::Document> cart;
+    std::expected<std::string_view, std::string> batch{std::unexpect, "Batch wasn't built."};
+
+    StageGraph graph;
+    const auto authentication = graph.add("Checking authentication", checkAuthentication, [&] {
+        authenticate(task);
+    });
+    const auto term = graph.add("Confirming term", confirmTerm, [&] {
+        confirmRegistrationTerm(task);
+    }, {authentication});
+    const auto visit = graph.add("Visiting class registration", visitClassRegistration, [&] {
+        fetchOldModel(task, task.sessionManager.getSession());
+    }, {term});
+    const auto cartAdd = graph.add(burst ? "Opening burst" : "Adding CRNs to cart", true, [&] {
+        task.requestTemplates.prepare(task.config.termCode, task.sessionManager.uniqueSessionId);
+        if (!task.hedges.empty()) {
+            const StringSet& queue = task.courseManager.getRegistrationQueue();
+            task.hedges.addToCarts(task, task.requestTemplates.encodeAddCrns(queue));
+        }
 
-    rapidjson::StringBuffer buffer;
-    rapidjson::Writer writer{buffer};
-    batch.Accept(writer);
+        if (burst) {
+            cart.emplace(addCrnsInBurst(task, cartBuffer));
+        } else {
+            cart.emplace(addCrnRegistrationItems(task, tookShortcuts, cartBuffer));
+        }
+    }, {visit});
+    const auto model = graph.addSideWork("Refreshing old model", refreshModel, [&] {
+        fetchOldModel(task, task.sessionManager.getSideSession());
+    }, {burst ? cartAdd : term});
+    graph.add("Building batch", true, [&] {
+        task.requestTemplates.beginBatch();
+
+        addCoursesToBatch(task, *cart);
+        if (task.requestTemplates.getUpdateCount() == 0) {
+            batch = std::unexpected{"Added no courses to batch."};
+            return;
+        }
+
+        addDropsToBatch(task);
+        if (const std::size_t dropQueueSize = task.courseManager.getDropQueue().size(); dropQueueSize > 0) {
+            task.logger.info("Added {} course{} to drop queue.", dropQueueSize, determinePlural(dropQueueSize));
+        }
 
-    return std::expected<std::string, std::string>{std::in_place, buffer.GetString(), buffer.GetLength()};
+        batch = task.requestTemplates.finishBatch();
+    }, {cartAdd, model});
+
+    try {
+        graph.run();
+    } catch (const NavigationRejected& e) {
+        if (!tookShortcuts) {
+            throw;
+        }
+
+        task.logger.info("{}. Retrying with every navigation step.", e.what());
+        return prepareBatch(task, false);
+    }
+
+    recordStages(task, graph);
+    return batch;
 }
 
 void finalizeRegistration(Task& task) {
@@ -278,19 +460,32 @@ void finalizeRegistration(Task& task) {
     task.logger.info("Added {} course{} to registration queue.", queueSize, determinePlural(queueSize));
 
     const auto startTime = std::chrono::steady_clock::now();
-    prepareForRegistration(task);
-
-    const auto batch = prepareBatch(task);
+    const std::uint64_t startAllocations = getAllocationCount();
+    const auto batch = prepareBatch(task, true);
     if (!batch) {
-        logDuration(task.logger, startTime, "Registration (no courses)");
+        logDuration(task, startTime, "Registration (no courses)");
         task.logger.error(batch.error());
+        task.logger.dumpFlightRecorder(batch.error());
         return;
     }
 
-    const std::string batchResponse = sendBatch(task, *batch);
-    logDuration(task.logger, startTime, "Registration");
+    saveCheckpoint(task);
+    std::vector<std::string> batchResponses = sendBatch(task, *batch);
+    logDuration(task, startTime, "Registration");
+
+    if (allocationCountingEnabled()) {
+        task.logger.debug("Preparing and sending the batch made {} allocations.",
+            getAllocationCount() - startAllocations);
+    }
+
+    if (const auto opening = task.seatOpenings.take()) {
+        const auto latency = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - opening->observedAt);
+        task.logger.info("Submitted {}ms after another task saw CRN {} open.", latency.count(), opening->crn);
+        logDuration(task, opening->observedAt, "Seat opening to submission");
+    }
 
-    reviewBatchResponse(task, batchResponse);
+    reviewBatchResponses(task, batchResponses);
 }
 
 CrnRef selectBestCandidate(const std::vector<CrnRef>& candidates, const bool prioritizeOpenSeats) {
@@ -318,6 +513,10 @@ bool crnIsAddable(const CourseStatus status, const bool waitlistConsideredAddabl
     return status == CourseStatus::Open || (status == CourseStatus::WaitlistOpen && waitlistConsideredAddable);
 }
 
+bool isOpening(const CourseStatus status) {
+    return status == CourseStatus::Open || status == CourseStatus::WaitlistOpen;
+}
+
 std::vector<CrnRef> getCandidates(const Task& task, Course& course) {
     std::vector<CrnRef> toCheck;
     toCheck.reserve(1 + course.backups.size());
@@ -331,9 +530,21 @@ std::vector<CrnRef> getCandidates(const Task& task, Course& course) {
     futures.reserve(toCheck.size());
     for (auto& check : toCheck) {
         futures.emplace_back(std::async(std::launch::async, [&] {
+            LatencyMode::releaseCurrentThread();
             CRN& crn = check.get();
-            crn.enrollmentInfo = checkEnrollmentAvailability(task.config.termCode, crn.value);
-            task.logger.info("{} - {}", crn, crn.enrollmentInfo.getDescription());
+            const EnrollmentInfo previous = std::exchange(crn.enrollmentInfo,
+                checkEnrollmentAvailability(task.config.termCode, crn.value));
+
+            SeatHistory::instance().record(task.config.termCode, crn.value, crn.enrollmentInfo);
+
+            if (!isOpening(previous.status) && isOpening(crn.enrollmentInfo.status)) {
+                SeatEventBus::instance().publish(SeatOpening{task.config.termCode, crn.value,
+                    crn.enrollmentInfo.status, std::chrono::steady_clock::now()}, &task);
+            }
+
+            // Unchanged seats are only logged at debug level
+            task.events.seatCheck(crn, previous);
+            task.seatWatch.recordCheck(previous != crn.enrollmentInfo);
         }));
     }
 
@@ -374,6 +585,7 @@ void processCourses(Task& task) {
 
     for (Course& course : task.courseManager.getCourses()) {
         futures.emplace_back(std::async(std::launch::async, [&] {
+            LatencyMode::releaseCurrentThread();
             return processCourse(task, course);
         }));
     }
@@ -387,7 +599,7 @@ void processCourses(Task& task) {
                 task.courseManager.enqueueDrop(*drop);
             }
 
-            task.logger.info("Enqueuing {}.", best.get());
+            task.events.enqueued(best.get());
         }
     }
 
@@ -395,13 +607,37 @@ void processCourses(Task& task) {
     notifyResults(task);
 }
 
-void sleepForRandomTime(Task& task, std::uniform_real_distribution<>& dist, std::mt19937& gen) {
-    const double sleepDuration = dist(gen);
-    task.logger.info("Checking again in {:.2f} seconds.", sleepDuration);
-    task.scheduler.pauseFor(task.logger, std::chrono::duration<double>{sleepDuration});
+void sleepUntilNextCheck(Task& task, const PollingPlanner& planner, std::mt19937& gen) {
+    const auto sleepDuration = planner.nextInterval(gen);
+    task.events.nextCheck(std::chrono::duration_cast<std::chrono::milliseconds>(sleepDuration));
+    if (task.scheduler.pauseUntilWoken(task.logger, sleepDuration)) {
+        task.logger.info("Another task saw a watched CRN open. Checking now.");
+    }
     task.scheduler.throwIfStopped();
 }
 
+// Wakes the task whenever another task sees one of its CRNs open
+std::vector<SeatEventBus::Subscription> subscribeToOpenings(Task& task) {
+    std::vector<SeatEventBus::Subscription> subscriptions;
+
+    const auto subscribe = [&](const CRN& crn) {
+        subscriptions.push_back(SeatEventBus::instance().subscribe(task.config.termCode, crn.value, &task,
+            [&task](const SeatOpening& opening) {
+                task.seatOpenings.deliver(opening);
+                task.scheduler.wake();
+            }));
+    };
+
+    for (const Course& course : task.courseManager.getCourses()) {
+        subscribe(course.primary);
+        for (const CRN& backup : course.backups) {
+            subscribe(backup);
+        }
+    }
+
+    return subscriptions;
+}
+
 // Returns true if processed courses without errors, false if encountered a recoverable error.
 // If error is unrecoverable or the user cancelled the task, it'll just throw.
 bool attemptRegistration(Task& task) {
@@ -421,21 +657,51 @@ bool attemptRegistration(Task& task) {
 
     return true;
 }
+
+// Seat watching afterwards doesn't need it, and shouldn't keep a core to itself
+void leaveLatencyModeIfOver(Task& task) {
+    if (task.latencyMode.isActive() &&
+            std::chrono::system_clock::now() >= task.scheduler.getLocalOpeningTime() + LatencyMode::LINGER) {
+        task.latencyMode.leave(task.logger);
+    }
+}
 } // namespace
 
 void registrationLoop(Task& task) {
-    static constexpr double MIN_WAIT_SECONDS = 3.0;
-    static constexpr double MAX_WAIT_SECONDS = 6.0;
     static constexpr int REAUTHENTICATE_AFTER = 500;
 
     std::random_device rd;
     std::mt19937 gen{rd()};
-    std::uniform_real_distribution timeDist{MIN_WAIT_SECONDS, MAX_WAIT_SECONDS};
+    PollingPlanner planner;
+    const auto subscriptions = subscribeToOpenings(task);
 
-    int attempts = 0;
+    task.metrics.setState("Registering");
 
     while (!task.courseManager.getCourses().empty()) {
-        if (!attemptRegistration(task)) {
+        const std::uint64_t startAllocations = getAllocationCount();
+        const bool succeeded = attemptRegistration(task);
+        const bool burstUnfired = task.openingBurst.report(task);
+        task.hedges.settle();
+        leaveLatencyModeIfOver(task);
+        if (allocationCountingEnabled()) {
+            task.logger.debug("Registration cycle made {} allocations.", getAllocationCount() - startAllocations);
+        }
+
+        saveCheckpoint(task);
+
+        // Nothing was submitted for it, e.g. the seat was already gone by the time this task checked
+        if (const auto opening = task.seatOpenings.take()) {
+            task.logger.debug("Didn't submit after CRN {} opened for another task.", opening->crn);
+        }
+
+        // Later cycles go straight to registering, so they have to know registration is open first
+        if (burstUnfired && !task.courseManager.getCourses().empty()) {
+            task.metrics.setState("Waiting for registration to open");
+            waitForRegistrationToOpen(task);
+            task.metrics.setState("Registering");
+        }
+
+        if (!succeeded) {
             continue;
         }
 
@@ -449,12 +715,121 @@ void registrationLoop(Task& task) {
             break;
         }
 
-        if (++attempts >= REAUTHENTICATE_AFTER) {
+        if (const auto summary = task.seatWatch.takeSummaryIfDue(task.courseManager.getCourses())) {
+            task.logger.info(*summary);
+        }
+
+        if (const auto plan = planner.replanIfDue(task.config.termCode, task.courseManager.getCourses())) {
+            task.logger.info(*plan);
+        }
+
+        if (++task.sessionManager.cyclesSinceAuthentication >= REAUTHENTICATE_AFTER) {
             authenticate(task);
-            attempts = 0;
+            task.sessionManager.cyclesSinceAuthentication = 0;
         }
 
         task.courseManager.resetFailedCount();
-        sleepForRandomTime(task, timeDist, gen);
+        task.metrics.setState("Watching for open seats");
+        sleepUntilNextCheck(task, planner, gen);
+    }
+
+    task.latencyMode.leave(task.logger);
+}
+
+void rehearseRegistration(Task& task) {
+    task.metrics.setState("Rehearsing registration");
+    const auto startTime = std::chrono::steady_clock::now();
+
+    std::mutex failuresMutex;
+    std::vector<std::string> failures;
+
+    // A failed step is noted instead of stopping the rest
+    const auto attempt = [&](const std::string_view step, std::function<void()> work) {
+        return [&failuresMutex, &failures, step, work = std::move(work)] {
+            try {
+                work();
+            } catch (const TaskCancelled&) {
+                throw;
+            } catch (const std::exception& e) {
+                std::lock_guard lock{failuresMutex};
+                failures.push_back(fmt::format("{} - {}", step, e.what()));
+            }
+        };
+    };
+
+    // What the rehearsal finds is kept to itself. The real registration's navigation state and old model are left
+    // alone, so that it doesn't skip steps or drops because of something the rehearsal did half an hour earlier. The
+    // old model still goes through the same in-place parse as the real one, into a page and allocator of its own.
+    bool termConfirmed = false;
+    std::string page;
+    rapidjson::MemoryPoolAllocator<> modelAllocator;
+    rapidjson::Document oldModel;
+
+    // Registration isn't open yet, so this should only get as far as the portal saying so
+    StageGraph graph;
+    const auto navigation = graph.add("Rehearsal - navigating", true, attempt("Navigating", [&] {
+        cpr::Session& session = task.sessionManager.getSession();
+        visitRegistrationDashboard(session);
+        registrationTermSelect(session);
+        termConfirmed = confirmTermIfOpen(session, task.sessionManager.uniqueSessionId, task.config.termCode);
+    }));
+    const auto visit = graph.add("Rehearsal - visiting class registration", true,
+        attempt("Visiting class registration", [&] {
+            try {
+                page = visitClassRegistration(task.sessionManager.getSession());
+                oldModel = parseOldModel(page, modelAllocator);
+            } catch (const std::exception& e) {
+                if (termConfirmed) {
+                    throw;
+                }
+
+                // The portal might not show the page until registration opens
+                task.logger.debug("Couldn't visit class registration before registration opened - {}.", e.what());
+            }
+        }), {navigation});
+    graph.add("Rehearsal - connecting other sessions", true, attempt("Connecting other sessions", [&] {
+        visitRegistrationDashboard(task.sessionManager.getSideSession());
+
+        const auto probeSessions = std::max(static_cast<std::size_t>(task.config.openProbeSessions),
+            task.config.openingBurstMs.size());
+        for (std::size_t i = 0; i < probeSessions; ++i) {
+            visitRegistrationDashboard(*task.sessionManager.getProbeSession(i));
+        }
+    }));
+    graph.add("Rehearsal - building batch", true, attempt("Building batch", [&] {
+        StringSet crns;
+        for (const Course& course : task.courseManager.getCourses()) {
+            crns.insert(course.primary.value);
+        }
+
+        task.requestTemplates.prepare(task.config.termCode, task.sessionManager.uniqueSessionId);
+        static_cast<void>(task.requestTemplates.encodeAddCrns(crns));
+
+        // The currently registered courses stand in for the cart
+        task.requestTemplates.beginBatch();
+        if (oldModel.IsArray()) {
+            for (const auto& model : oldModel.GetArray()) {
+                task.requestTemplates.appendUpdate(model);
+            }
+        }
+
+        const rapidjson::Document batch = parseJsonResponse(task.requestTemplates.finishBatch());
+        if (!batch.IsObject() || !batch.HasMember("update") ||
+            batch["update"].Size() != task.requestTemplates.getUpdateCount()) {
+            throw std::runtime_error{"Built a malformed batch"};
+        }
+    }), {visit});
+
+    graph.run();
+    recordStages(task, graph);
+
+    const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime);
+    if (failures.empty()) {
+        task.logger.info("Rehearsed registration in {}ms.", duration.count());
+        return;
     }
-}
\ No newline at end of file
+
+    task.logger.warn("Rehearsal failed: {}", fmt::join(failures, "; "));
+    task.logger.dumpFlightRecorder("Rehearsal failed");
+}
@@ -5,4 +5,8 @@
 
 void registrationLoop(Task& task);
 
+// Runs every step of a registration against the live session except submitting the batch, so that connections,
+// allocators, and code are warm when it counts. Failed steps are logged, not thrown.
+void rehearseRegistration(Task& task);
+
 #endif // REGISTER_H
\ No newline at end of file
@@ -1,28 +1,106 @@
 #include "registration/RegistrationUtil.h"
 #include "auth/Authentication.h"
 #include "data/Links.h"
+#include "registration/Register.h"
+#include "task/TaskCheckpoint.h"
+#include "util/Exceptions.h"
 #include "util/Requests.h"
 #include "util/Utility.h"
 
-namespace {
-void registrationTermSelect(cpr::Session& session) {
-    sendRequest(session, RequestMethod::HEAD, Link::Reg::TERM_SELECT_CLASS_REG);
-}
+#include <fmt/ranges.h>
 
-std::string registrationConfirmTerm(const SessionManager& sessionManager, const std::string& termCode) {
-    return sendRequest(sessionManager.getSession(), RequestMethod::POST, Link::Reg::TERM_CONFIRM_CLASS_REG,
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+std::string registrationConfirmTerm(cpr::Session& session, const std::string_view uniqueSessionId,
+        const std::string& termCode) {
+    return sendRequest(session, RequestMethod::POST, Link::Reg::TERM_CONFIRM_CLASS_REG,
         cpr::Payload{
             {"term", termCode},
             {"studyPath", ""},
             {"studyPathText", ""},
             {"startDatepicker", ""},
             {"endDatepicker", ""},
-            {"uniqueSessionId", sessionManager.uniqueSessionId}
+            {"uniqueSessionId", std::string{uniqueSessionId}}
         }
     ).text;
 }
 
-std::string extractSummaryModels(const std::string_view responseText) {
+void waitForActivation(Task& task) {
+    using namespace std::chrono_literals;
+    static constexpr std::chrono::minutes KEEP_WARM_INTERVAL{5};
+
+    task.metrics.setState("Standby");
+    task.logger.info("Standing by until the primary instance stops responding.");
+
+    auto lastWarmed = std::chrono::steady_clock::now();
+    while (!task.isActive()) {
+        task.scheduler.pauseFor(task.logger, 250ms);
+        task.scheduler.throwIfStopped();
+
+        // Cheap while the session is still valid, and logs back in when it isn't
+        if (std::chrono::steady_clock::now() - lastWarmed >= KEEP_WARM_INTERVAL) {
+            authenticate(task);
+            lastWarmed = std::chrono::steady_clock::now();
+        }
+    }
+
+    // Pick up whatever the primary finished before it stopped, but keep this instance's own session, which its
+    // navigation state belongs to
+    const auto startTime = std::chrono::steady_clock::now();
+    restoreCheckpoint(task, false);
+    logDuration(task, startTime, "Taking over");
+    task.logger.info("Took over from the primary instance.");
+}
+
+void waitUntilPortalOnline(Task& task) {
+    using namespace std::chrono_literals;
+    while (portalIsDown()) {
+        task.scheduler.pauseFor(task.logger, 5s, "for portal to come back online");
+    }
+}
+
+// CRNs a batch was being submitted for when the task last stopped are completed if the class registration page shows
+// they went through, so that they aren't submitted a second time
+void reconcileUnconfirmedCrns(Task& task) {
+    const std::vector<std::string> unconfirmed = task.courseManager.takeUnconfirmedCrns();
+    if (unconfirmed.empty()) {
+        return;
+    }
+
+    try {
+        confirmRegistrationTerm(task);
+        fetchOldModel(task, task.sessionManager.getSession());
+    } catch (const TaskCancelled&) {
+        throw;
+    } catch (const std::exception& e) {
+        task.logger.warn("Couldn't check whether CRNs {} were registered: {}. They will be submitted again.",
+            fmt::join(unconfirmed, ", "), e.what());
+        return;
+    }
+
+    const rapidjson::Document& oldModel = task.courseManager.getOldModel();
+    for (const std::string& crn : unconfirmed) {
+        const bool registered = oldModel.IsArray() && std::ranges::any_of(oldModel.GetArray(),
+            [&](const rapidjson::Value& model) {
+                return model.HasMember("courseReferenceNumber") && model["courseReferenceNumber"].IsString() &&
+                    model["courseReferenceNumber"].GetString() == crn;
+            });
+
+        if (registered) {
+            task.logger.info("CRN {} was registered before the last shutdown.", crn);
+            task.courseManager.completeCourse(crn);
+        } else {
+            task.logger.info("CRN {} wasn't registered before the last shutdown.", crn);
+        }
+    }
+
+    saveCheckpoint(task);
+}
+} // namespace
+
+std::string_view extractSummaryModels(const std::string_view responseText) {
     // This is probably not the best way to do this, but it works...
     // This little snippet is embedded within the HTML for the class registration page.
     // We're only interested in the summaryModels array, which contains all the
@@ -51,52 +129,25 @@ std::string extractSummaryModels(const std::string_view responseText) {
         clampBetween(responseText, SUMMARY_MODELS_START, SUMMARY_MODELS_END)
     );
 
-    return std::string{models.substr(0, models.size() - 1)}; // Remove the trailing comma
-}
-
-bool registrationIsOpen(const SessionManager& sessionManager, const std::string& termCode) {
-    visitRegistrationDashboard(sessionManager.getSession());
-    registrationTermSelect(sessionManager.getSession());
-
-    // An example of a request from ineligible user.
-    // `studentEligFailures` shows up whenever registration isn't open for the user yet,
-    // whether it be that registration isn't open yet or if they are ineligible to register (hold, not enrolled, etc.).
-    // We cover the ineligible case during the first authentication though.
-    //
-    // Whenever registration opens, the only thing here will be "fwdURL".
-    //
-    // {
-    //     "studentEligValid": false,
-    //     "studentEligFailures":
-    //     [
-    //       "You have no Registration Time Ticket for the current time."
-    //     ],
-    //     "fwdURL": "/StudentRegistrationSsb/ssb/classRegistration/classRegistration"
-    // }
-    const rapidjson::Document json = parseJsonResponse(registrationConfirmTerm(sessionManager, termCode));
-
-    return !json.HasMember("studentEligFailures");
-}
-
-void waitUntilPortalOnline(Task& task) {
-    using namespace std::chrono_literals;
-    while (portalIsDown()) {
-        task.scheduler.pauseFor(task.logger, 5s, "for portal to come back online");
-    }
+    return models.substr(0, models.size() - 1); // Remove the trailing comma
 }
-} // namespace
 
 
-void logDuration(const TaskLogger& logger, const std::chrono::steady_clock::time_point start,
+void logDuration(const Task& task, const std::chrono::steady_clock::time_point start,
         const std::string_view stage) {
     const auto end = std::chrono::steady_clock::now();
-    const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
-    logger.debug("{} took {} ms", stage, duration.count());
+    recordDuration(task, stage, std::chrono::duration_cast<std::chrono::milliseconds>(end - start));
+}
+
+void recordDuration(const Task& task, const std::string_view stage, const std::chrono::milliseconds duration) {
+    task.events.stageTiming(stage, duration);
+    task.metrics.recordDuration(stage, duration);
 }
 
 void waitOutError(Task& task, const std::string& message) {
     notifyFailure(task, "Error", message);
     task.courseManager.clearQueues();
+    task.sessionManager.navigation = {};
     waitUntilPortalOnline(task);
 
     // We ignore HTTP 502 and 504 errors since they're just temporary, likely just the server rebooting.
@@ -108,6 +159,7 @@ void waitOutError(Task& task, const std::string& message) {
 
 void notifyFailure(const Task& task, const std::string& title, const std::string& message) {
     task.logger.error(title + " - " + message);
+    task.logger.dumpFlightRecorder(title + " - " + message);
     sendDiscordNotification(task, title, message);
 }
 
@@ -115,6 +167,10 @@ void visitRegistrationDashboard(cpr::Session& session) {
     sendRequest(session, RequestMethod::HEAD, Link::Reg::REG_DASHBOARD);
 }
 
+void registrationTermSelect(cpr::Session& session) {
+    sendRequest(session, RequestMethod::HEAD, Link::Reg::TERM_SELECT_CLASS_REG);
+}
+
 std::string visitClassRegistration(cpr::Session& session) {
     return sendRequest(session, RequestMethod::GET, Link::Reg::CLASS_REG).text;
 }
@@ -122,48 +178,157 @@ std::string visitClassRegistration(cpr::Session& session) {
 void prepareTask(Task& task) {
     task.scheduler.throwIfStopped();
 
+    restoreCheckpoint(task);
+    if (task.courseManager.getCourses().empty()) {
+        task.logger.info("Every course was already handled before the last shutdown.");
+        return;
+    }
+
+    task.metrics.setState("Authenticating");
     authenticate(task);
 
     task.courseManager.populateCourseDetails(task.sessionManager.getSession(), task.config.termCode);
     task.courseManager.displayCourses(task.logger);
+    saveCheckpoint(task);
+
+    if (!task.isActive()) {
+        waitForActivation(task);
+
+        if (task.courseManager.getCourses().empty()) {
+            task.logger.info("Every course was already handled by the previous primary.");
+            return;
+        }
+    }
+
+    reconcileUnconfirmedCrns(task);
+    if (task.courseManager.getCourses().empty()) {
+        task.logger.info("Every course was registered before the last shutdown.");
+        return;
+    }
 
     task.logger.info("Registration time: " + task.scheduler.getRegistrationTime());
+    task.scheduler.hibernateIfEarly(task.logger, std::chrono::minutes{task.config.hibernateMinutesBefore});
+
+    task.metrics.setState("Waiting for registration time");
+    task.scheduler.sleepUntilCalibration(task.logger);
+    task.scheduler.calibrateClock(task.sessionManager.getSession(), task.logger);
+    task.hedges.prepare(task); // Signing in takes a while, so the first time is well ahead of registration
+
+    if (task.scheduler.sleepUntilRehearsal(task.logger)) {
+        rehearseRegistration(task);
+        task.metrics.setState("Waiting for registration time");
+    }
+
+    if (task.config.latencyCriticalMode) {
+        task.scheduler.pauseUntil(task.logger, task.scheduler.getLocalOpeningTime() - LatencyMode::LEAD,
+            "before entering latency-critical mode");
+        task.scheduler.throwIfStopped();
+        task.latencyMode.enter(task.logger);
+    }
 
     task.scheduler.sleepUntilReauthentication(task.logger);
     authenticate(task);
+    task.hedges.startPreparing(task);
+    task.requestTemplates.prepare(task.config.termCode, task.sessionManager.uniqueSessionId);
+    saveCheckpoint(task);
+
+    // Navigated once up front, so that the probes (or the opening burst's shots) only have to confirm the term
+    visitRegistrationDashboard(task.sessionManager.getSession());
+    registrationTermSelect(task.sessionManager.getSession());
+
+    if (!task.config.openingBurstMs.empty()) {
+        // Leaves the first registration cycle time to check seats before the first shot is due
+        static constexpr std::chrono::seconds BURST_LEAD{2};
+        const auto firstShot = task.scheduler.getLocalOpeningTime() +
+            std::chrono::milliseconds{task.config.openingBurstMs.front()};
+
+        task.scheduler.pauseUntil(task.logger, firstShot - BURST_LEAD, "before the opening burst");
+        task.openingBurst.arm();
+        return;
+    }
 
     task.scheduler.sleepUntilOpen(task.logger);
+    task.metrics.setState("Waiting for registration to open");
+    waitForRegistrationToOpen(task);
+}
+
+void waitForRegistrationToOpen(Task& task) {
+    using namespace std::chrono;
 
     // Sometimes, registration doesn't actually open right at the time it says it does. Liars.
-    while (!registrationIsOpen(task.sessionManager, task.config.termCode)) {
-        using namespace std::chrono_literals;
-        task.scheduler.throwIfStopped();
-        task.logger.info("Registration not yet open. Waiting...");
-        task.scheduler.pauseFor(task.logger, 1s);
+    const auto fastUntil = steady_clock::now() + seconds{task.config.openProbeWindowSeconds};
+    if (!task.openProbe.run(task, milliseconds{task.config.openProbeIntervalMs}, fastUntil)) {
+        task.logger.info("Registration still isn't open. Checking once a second from now on.");
+        task.openProbe.run(task, 1s, steady_clock::time_point::max());
     }
 
+    // The probe that found it open also left the term confirmed for the first registration
+    task.sessionManager.navigation.confirmedTerm = task.config.termCode;
+    task.sessionManager.navigation.visitedClassRegistration = false;
     task.logger.info("Registration is open.");
 }
 
-void prepareForRegistration(Task& task) {
-    const auto startTime = std::chrono::steady_clock::now();
-
-    authenticate(task);
+void confirmRegistrationTerm(Task& task) {
     visitRegistrationDashboard(task.sessionManager.getSession());
     registrationTermSelect(task.sessionManager.getSession());
-    registrationConfirmTerm(task.sessionManager, task.config.termCode);
+    registrationConfirmTerm(task.sessionManager.getSession(), task.sessionManager.uniqueSessionId,
+        task.config.termCode);
 
+    task.sessionManager.navigation.confirmedTerm = task.config.termCode;
+    task.sessionManager.navigation.visitedClassRegistration = false;
+}
+
+bool confirmTermIfOpen(cpr::Session& session, const std::string_view uniqueSessionId, const std::string& termCode) {
+    // An example of a request from ineligible user.
+    // `studentEligFailures` shows up whenever registration isn't open for the user yet,
+    // whether it be that registration isn't open yet or if they are ineligible to register (hold, not enrolled, etc.).
+    // We cover the ineligible case during the first authentication though.
+    //
+    // Whenever registration opens, the only thing here will be "fwdURL".
+    //
+    // {
+    //     "studentEligValid": false,
+    //     "studentEligFailures":
+    //     [
+    //       "You have no Registration Time Ticket for the current time."
+    //     ],
+    //     "fwdURL": "/StudentRegistrationSsb/ssb/classRegistration/classRegistration"
+    // }
+    const rapidjson::Document json = parseJsonResponse(registrationConfirmTerm(session, uniqueSessionId, termCode));
+    return !json.HasMember("studentEligFailures");
+}
+
+bool isCartResponse(const cpr::Response& response) {
+    if (cpr::status::is_redirect(response.status_code)) {
+        return false;
+    }
+
+    const rapidjson::Document cart = parseJsonResponse(response.text);
+    return cart.IsObject() && cart.HasMember("aaData") && cart["aaData"].IsArray();
+}
+
+void fetchOldModel(Task& task, cpr::Session& session) {
     // Get the old set of models from the class registration page. Kind of a lot of work.
-    task.courseManager.getAllocator().Clear();
-
-    task.courseManager.setOldModel(
-        parseJsonResponse(
-            extractSummaryModels(
-                visitClassRegistration(task.sessionManager.getSession())
-            ),
-            &task.courseManager.getAllocator()
-        )
-    );
+    std::string& page = task.courseManager.getOldModelBuffer();
+    page = visitClassRegistration(session);
 
-    logDuration(task.logger, startTime, "Preparing for registration");
-}
\ No newline at end of file
+    task.courseManager.getModelAllocator().Clear();
+    task.courseManager.setOldModel(parseOldModel(page, task.courseManager.getModelAllocator()));
+
+    task.sessionManager.navigation.visitedClassRegistration = true;
+    task.sessionManager.navigation.modelFresh = true;
+}
+
+rapidjson::Document parseOldModel(std::string& page, rapidjson::MemoryPoolAllocator<>& allocator) {
+    // The models are parsed where they sit in the page, after cutting it off right after them
+    const std::string_view models = extractSummaryModels(page);
+    if (models.empty()) {
+        // E.g. a login or error page in place of class registration
+        throw std::runtime_error{"Couldn't find the registered courses on the class registration page."};
+    }
+
+    const std::size_t begin = models.data() - page.data();
+    page[begin + models.size()] = '\0';
+
+    return parseJsonInsitu(page.data() + begin, &allocator);
+}
@@ -4,28 +4,59 @@
 #include "task/Task.h"
 
 #include <cpr/session.h>
+#include <rapidjson/document.h>
 
 #include <string>
+#include <string_view>
 
-// Outputs the duration of a task stage given a start time and stage name.
-void logDuration(const TaskLogger& logger, std::chrono::steady_clock::time_point start, std::string_view stage);
+// Outputs the duration of a task stage given a start time and stage name, and records it in the task's metrics.
+void logDuration(const Task& task, std::chrono::steady_clock::time_point start, std::string_view stage);
+
+// Like logDuration, for a duration that was measured elsewhere.
+void recordDuration(const Task& task, std::string_view stage, std::chrono::milliseconds duration);
 
 // Waits until the portal is back online.
 void waitOutError(Task& task, const std::string& message);
 
-// Notifies the user of a failure through the logger and Discord (if enabled).
+// Notifies the user of a failure through the logger and Discord (if enabled), and dumps the task's recent debug output.
 void notifyFailure(const Task& task, const std::string& title, const std::string& message);
 
 // Visits the registration dashboard.
 void visitRegistrationDashboard(cpr::Session& session);
 
+// Selects the term page for class registration, which comes before confirming the term.
+void registrationTermSelect(cpr::Session& session);
+
 // Visits the class registration page and returns its HTML content.
 std::string visitClassRegistration(cpr::Session& session);
 
-// Authenticates the user, checks CRNs, and waits until the user's registration time.
+// The JSON array of the user's registered courses within the class registration page's HTML. Empty if the page
+// doesn't have one.
+std::string_view extractSummaryModels(std::string_view responseText);
+
+// Authenticates the user, checks CRNs, and waits until the user's registration time. With an opening burst, returns
+// shortly before the first shot and leaves the burst armed for the first registration.
 void prepareTask(Task& task);
 
-// Sets up the task for the registration flow.
-void prepareForRegistration(Task& task);
+// Probes until registration is open, which leaves the term confirmed.
+void waitForRegistrationToOpen(Task& task);
+
+// Selects and confirms the term for class registration on the main session.
+void confirmRegistrationTerm(Task& task);
+
+// Confirms the term for class registration on the given session, and returns whether registration is open. Only
+// confirms anything when it is, and expects the dashboard and term selection to have been visited already.
+bool confirmTermIfOpen(cpr::Session& session, std::string_view uniqueSessionId, const std::string& termCode);
+
+// Whether a response to adding CRNs to the cart is a cart (which can still have failed CRNs in it).
+bool isCartResponse(const cpr::Response& response);
+
+// Visits the class registration page with the given session (either of the task's) and saves the courses the user
+// is currently registered for as the old model.
+void fetchOldModel(Task& task, cpr::Session& session);
+
+// Parses the registered courses on a class registration page in place, cutting the page off right after them, so the
+// page has to outlive the result. Throws if the page doesn't have them.
+rapidjson::Document parseOldModel(std::string& page, rapidjson::MemoryPoolAllocator<>& allocator);
 
 #endif // REGISTRATIONUTIL_H
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include "registration/RequestTemplates.h"
+
+#include <rapidjson/stringbuffer.h>
+
+namespace {
+// Comfortably more than a batch of every course in a config, so registration never has to grow the buffers
+constexpr std::size_t ADD_CRNS_CAPACITY = 1024;
+constexpr std::size_t BATCH_CAPACITY = 256 * 1024;
+
+// What cpr::Payload encodes the commas between CRNs as
+constexpr std::string_view ENCODED_COMMA = "%2C";
+
+std::string encodeBatchPrefix(const std::string_view sessionId) {
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer writer{buffer};
+
+    // Same members in the same order as the portal's own batches, up to the opening bracket of "update"
+    writer.StartObject();
+    writer.Key("create");
+    writer.StartArray();
+    writer.EndArray();
+    writer.Key("destroy");
+    writer.StartArray();
+    writer.EndArray();
+    writer.Key("uniqueSessionId");
+    writer.String(sessionId.data(), static_cast<rapidjson::SizeType>(sessionId.size()));
+    writer.Key("update");
+
+    return std::string{buffer.GetString(), buffer.GetLength()} + '[';
+}
+} // namespace
+
+RequestTemplates::RequestTemplates() : m_writer{m_batch} {
+    m_addCrns.reserve(ADD_CRNS_CAPACITY);
+    m_batch.str.reserve(BATCH_CAPACITY);
+}
+
+void RequestTemplates::prepare(const std::string_view termCode, const std::string_view uniqueSessionId) {
+    if (termCode != m_termCode) {
+        m_termCode = termCode;
+        m_addCrnsSuffix = "&term=" + m_termCode; // Term codes are digits, so they don't need encoding
+    }
+
+    if (uniqueSessionId != m_sessionId) {
+        m_sessionId = uniqueSessionId;
+        m_batchPrefix = encodeBatchPrefix(m_sessionId);
+    }
+}
+
+std::string_view RequestTemplates::encodeAddCrns(const StringSet& crns) {
+    m_addCrns = "crnList=";
+
+    bool first = true;
+    for (const std::string& crn : crns) {
+        if (!first) {
+            m_addCrns += ENCODED_COMMA;
+        }
+
+        m_addCrns += crn; // CRNs are digits too
+        first = false;
+    }
+
+    m_addCrns += m_addCrnsSuffix;
+    return m_addCrns;
+}
+
+void RequestTemplates::beginBatch() {
+    m_batch.str = m_batchPrefix;
+    m_updateCount = 0;
+}
+
+void RequestTemplates::appendUpdate(const rapidjson::Value& model) {
+    if (m_updateCount++ > 0) {
+        m_batch.Put(',');
+    }
+
+    // Each model is its own JSON document as far as the writer is concerned
+    m_writer.Reset(m_batch);
+    model.Accept(m_writer);
+}
+
+std::size_t RequestTemplates::getUpdateCount() const noexcept {
+    return m_updateCount;
+}
+
+std::string_view RequestTemplates::finishBatch() {
+    m_batch.str += "]}";
+    return m_batch.str;
+}
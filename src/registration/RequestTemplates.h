@@ -0,0 +1,64 @@
+#ifndef REQUESTTEMPLATES_H
+#define REQUESTTEMPLATES_H
+
+#include "util/Utility.h"
+
+#include <rapidjson/document.h>
+#include <rapidjson/writer.h>
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Bodies of the two registration requests, encoded ahead of time.
+//
+// Everything that's known before registration opens (the term, the session ID, the JSON around the batch's updates)
+// is encoded by prepare(), and the buffers are reserved up front, so building a request at registration time only
+// splices the CRNs or models into place without allocating.
+class RequestTemplates {
+public:
+    RequestTemplates();
+
+    RequestTemplates(const RequestTemplates&) = delete;
+    RequestTemplates& operator=(const RequestTemplates&) = delete;
+
+    // Call after authenticating. Only re-encodes what changed since the last call.
+    void prepare(std::string_view termCode, std::string_view uniqueSessionId);
+
+    // Form body for addCRNRegistrationItems. Valid until the next call.
+    [[nodiscard]] std::string_view encodeAddCrns(const StringSet& crns);
+
+    // The batch is built with beginBatch(), one appendUpdate() per model, then finishBatch(), whose result is valid
+    // until the next beginBatch().
+    void beginBatch();
+    void appendUpdate(const rapidjson::Value& model);
+    [[nodiscard]] std::size_t getUpdateCount() const noexcept;
+    [[nodiscard]] std::string_view finishBatch();
+
+private:
+    // Lets rapidjson's Writer serialize straight into a reserved std::string
+    struct StringOutputStream {
+        using Ch = char;
+
+        void Put(const char c) {
+            str.push_back(c);
+        }
+
+        void Flush() {}
+
+        std::string str;
+    };
+
+    std::string m_termCode;
+    std::string m_sessionId;
+
+    std::string m_addCrnsSuffix; // "&term=<term code>"
+    std::string m_addCrns;
+
+    std::string m_batchPrefix; // Everything up to the first update
+    StringOutputStream m_batch;
+    rapidjson::Writer<StringOutputStream> m_writer;
+    std::size_t m_updateCount = 0;
+};
+
+#endif // REQUESTTEMPLATES_H
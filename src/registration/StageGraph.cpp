@@ -0,0 +1,152 @@
+#include "registration/StageGraph.h"
+#include "task/LatencyMode.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <exception>
+#include <future>
+#include <iterator>
+#include <ranges>
+#include <stdexcept>
+
+StageGraph::StageId StageGraph::add(const std::string_view name, const bool needed, std::function<void()> work,
+        std::vector<StageId> dependencies) {
+    if (std::ranges::any_of(dependencies, [&](const StageId dependency) { return dependency >= m_stages.size(); })) {
+        throw std::runtime_error{fmt::format("Stage {} depends on a stage that hasn't been added.", name)};
+    }
+
+    m_stages.push_back(Stage{needed ? std::move(work) : nullptr, std::move(dependencies)});
+    m_timings.push_back(Timing{.name = name, .skipped = !needed});
+
+    return m_stages.size() - 1;
+}
+
+StageGraph::StageId StageGraph::addSideWork(const std::string_view name, const bool needed,
+        std::function<void()> work, std::vector<StageId> dependencies) {
+    const StageId id = add(name, needed, std::move(work), std::move(dependencies));
+    m_stages[id].sideWork = true;
+
+    return id;
+}
+
+void StageGraph::run() {
+    const auto runStart = std::chrono::steady_clock::now();
+
+    // What has to finish before each stage counts as finished. That's the stage's own thread, except that a skipped
+    // stage gets no thread and simply stands for everything it depends on.
+    std::vector<std::vector<std::shared_future<void>>> finished;
+    finished.reserve(m_stages.size());
+
+    std::vector<std::shared_future<void>> running;
+    running.reserve(m_stages.size());
+
+    for (StageId id = 0; id < m_stages.size(); ++id) {
+        std::vector<std::shared_future<void>> dependencies;
+        for (const StageId dependency : m_stages[id].dependencies) {
+            dependencies.insert(dependencies.end(), finished[dependency].begin(), finished[dependency].end());
+        }
+
+        if (!m_stages[id].work) {
+            finished.push_back(std::move(dependencies));
+            continue;
+        }
+
+        // The last stage only runs once the caller would be waiting anyway, so it runs on the caller's thread
+        const auto policy = id + 1 == m_stages.size() ? std::launch::deferred : std::launch::async;
+
+        // Each thread only touches its own stage and timing
+        running.push_back(std::async(policy, [this, id, runStart, policy, dependencies = std::move(dependencies)] {
+            if (m_stages[id].sideWork && policy == std::launch::async) {
+                LatencyMode::releaseCurrentThread();
+            }
+
+            for (const auto& dependency : dependencies) {
+                dependency.get(); // Rethrows a dependency's failure instead of running
+            }
+
+            Timing& timing = m_timings[id];
+            timing.start = std::chrono::steady_clock::now() - runStart;
+            m_stages[id].work();
+            timing.end = std::chrono::steady_clock::now() - runStart;
+        }).share());
+        finished.push_back({running.back()});
+    }
+
+    std::exception_ptr firstFailure;
+    for (const auto& stage : running) {
+        try {
+            stage.get();
+        } catch (...) {
+            if (!firstFailure) {
+                firstFailure = std::current_exception();
+            }
+        }
+    }
+
+    // A skipped stage finishes as soon as its dependencies do
+    for (StageId id = 0; id < m_stages.size(); ++id) {
+        if (!m_stages[id].work) {
+            const auto& dependencies = m_stages[id].dependencies;
+            const auto end = dependencies.empty() ? std::chrono::steady_clock::duration{} :
+                std::ranges::max(dependencies | std::views::transform([&](const StageId dependency) {
+                    return m_timings[dependency].end;
+                }));
+            m_timings[id].start = end;
+            m_timings[id].end = end;
+        }
+    }
+
+    if (firstFailure) {
+        std::rethrow_exception(firstFailure);
+    }
+}
+
+const std::vector<StageGraph::Timing>& StageGraph::getTimings() const noexcept {
+    return m_timings;
+}
+
+std::string StageGraph::describeCriticalPath() const {
+    if (m_stages.empty()) {
+        return "";
+    }
+
+    const auto finishedEarlier = [&](const StageId a, const StageId b) {
+        return m_timings[a].end < m_timings[b].end;
+    };
+
+    // Walk back from the stage that finished last, always through the dependency that held it up the longest
+    std::vector<StageId> path;
+    StageId current = 0;
+    for (StageId id = 1; id < m_stages.size(); ++id) {
+        current = std::max(current, id, finishedEarlier);
+    }
+
+    while (true) {
+        path.push_back(current);
+
+        const auto& dependencies = m_stages[current].dependencies;
+        if (dependencies.empty()) {
+            break;
+        }
+
+        current = *std::ranges::max_element(dependencies, finishedEarlier);
+    }
+
+    std::string description;
+    for (auto it = path.rbegin(); it != path.rend(); ++it) {
+        const Timing& timing = m_timings[*it];
+        if (timing.skipped) {
+            continue;
+        }
+
+        if (!description.empty()) {
+            description += " -> ";
+        }
+
+        const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(timing.end - timing.start);
+        fmt::format_to(std::back_inserter(description), "{} ({}ms)", timing.name, duration.count());
+    }
+
+    return description;
+}
@@ -0,0 +1,57 @@
+#ifndef STAGEGRAPH_H
+#define STAGEGRAPH_H
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Runs named stages in dependency order. Each stage starts on its own thread as soon as everything it depends on has
+// finished, so independent stages overlap. Stages with nothing to do get no thread and don't hold up the rest, and
+// the last stage runs on the thread calling run(). Side-work stages give up latency-critical mode's core and priority
+// when they start.
+class StageGraph {
+public:
+    using StageId = std::size_t;
+
+    struct Timing {
+        std::string_view name;
+        bool skipped = false;
+        // Relative to the start of run()
+        std::chrono::steady_clock::duration start{};
+        std::chrono::steady_clock::duration end{};
+    };
+
+    // Dependencies must have been added already. A stage that isn't needed still orders the stages after it, but
+    // finishes as soon as its own dependencies do.
+    StageId add(std::string_view name, bool needed, std::function<void()> work, std::vector<StageId> dependencies = {});
+    // Like add(), for a stage off the critical path. It gives up latency-critical mode's core and priority (see
+    // LatencyMode::releaseCurrentThread) so that it doesn't compete with the stages that are on it.
+    StageId addSideWork(std::string_view name, bool needed, std::function<void()> work,
+        std::vector<StageId> dependencies = {});
+
+    // Returns once every stage has finished. If any stage threw, the stages that depend on it don't run and the
+    // first exception (in the order the stages were added) is rethrown.
+    void run();
+
+    // Only meaningful after run()
+    [[nodiscard]] const std::vector<Timing>& getTimings() const noexcept;
+
+    // The chain of stages that decided how long run() took, e.g. "Confirming term (120ms) -> Adding CRNs to cart
+    // (310ms)"
+    [[nodiscard]] std::string describeCriticalPath() const;
+
+private:
+    struct Stage {
+        std::function<void()> work;
+        std::vector<StageId> dependencies;
+        bool sideWork = false;
+    };
+
+    std::vector<Stage> m_stages;
+    std::vector<Timing> m_timings;
+};
+
+#endif // STAGEGRAPH_H
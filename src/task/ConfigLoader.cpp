@@ -1,10 +1,15 @@
 #include "task/ConfigLoader.h"
 #include "data/Terms.h"
+#include "task/SessionManager.h"
+#include "util/Utility.h"
 
 #include <cpr/cpr.h>
 #include <fmt/format.h>
 #include <toml++/toml.hpp>
 
+#include <algorithm>
+#include <functional>
+
 static bool discordWebhookValid(const std::string_view webhook) {
     static constexpr std::string_view EMPTY_WEBHOOK = "https://discord.com/api/webhooks/";
 
@@ -23,6 +28,39 @@ static void validateConfig(TaskConfig& config) {
             CWID_LENGTH, config.cwid.size())};
     }
 
+    if (config.hibernateMinutesBefore < 0) {
+        throw std::runtime_error{"hibernate_minutes_before can't be negative."};
+    }
+
+    if (config.openProbeIntervalMs <= 0) {
+        throw std::runtime_error{"open_probe_interval_ms must be positive."};
+    }
+
+    if (config.openProbeWindowSeconds < 0) {
+        throw std::runtime_error{"open_probe_window_seconds can't be negative."};
+    }
+
+    if (config.openingBurstMs.size() > SessionManager::MAX_PROBE_SESSIONS) {
+        throw std::runtime_error{fmt::format("opening_burst_ms can have at most {} shots.",
+            SessionManager::MAX_PROBE_SESSIONS)};
+    }
+
+    if (!std::ranges::is_sorted(config.openingBurstMs, std::less_equal{})) {
+        throw std::runtime_error{"opening_burst_ms must be in increasing order."};
+    }
+
+    // Each one signs in separately, which the portal might not appreciate in larger numbers
+    static constexpr int MAX_HEDGED_SESSIONS = 3;
+    if (config.hedgedSessions < 0 || config.hedgedSessions > MAX_HEDGED_SESSIONS) {
+        throw std::runtime_error{fmt::format("hedged_sessions must be between 0 and {}.", MAX_HEDGED_SESSIONS)};
+    }
+
+    static constexpr int MAX_PROBE_SESSIONS = static_cast<int>(SessionManager::MAX_PROBE_SESSIONS);
+    if (config.openProbeSessions < 1 || config.openProbeSessions > MAX_PROBE_SESSIONS) {
+        throw std::runtime_error{fmt::format("open_probe_sessions must be between 1 and {}.",
+            SessionManager::MAX_PROBE_SESSIONS)};
+    }
+
     config.enableNotifications = discordWebhookValid(config.discordWebhook);
 }
 
@@ -106,6 +144,27 @@ static TaskConfig readSettings(const toml::parse_result& parsed) {
     taskConfig.displayCwid = settings["display_cwid"].value_or(taskConfig.displayCwid);
     taskConfig.enableLogs = settings["enable_logs"].value_or(taskConfig.enableLogs);
     taskConfig.watchForOpenSeats = settings["watch_for_open_seats"].value_or(taskConfig.watchForOpenSeats);
+    taskConfig.hibernateMinutesBefore = settings["hibernate_minutes_before"].value_or(
+        taskConfig.hibernateMinutesBefore);
+    taskConfig.openProbeIntervalMs = settings["open_probe_interval_ms"].value_or(taskConfig.openProbeIntervalMs);
+    taskConfig.openProbeSessions = settings["open_probe_sessions"].value_or(taskConfig.openProbeSessions);
+    taskConfig.openProbeWindowSeconds = settings["open_probe_window_seconds"].value_or(
+        taskConfig.openProbeWindowSeconds);
+
+    taskConfig.hedgedSessions = settings["hedged_sessions"].value_or(taskConfig.hedgedSessions);
+    taskConfig.latencyCriticalMode = settings["latency_critical_mode"].value_or(taskConfig.latencyCriticalMode);
+
+    if (const auto burst = settings["opening_burst_ms"].as_array()) {
+        taskConfig.openingBurstMs.clear();
+        for (auto&& offset : *burst) {
+            const auto value = offset.value<int>();
+            if (!value) {
+                throw std::runtime_error{"opening_burst_ms must only contain whole milliseconds."};
+            }
+
+            taskConfig.openingBurstMs.push_back(*value);
+        }
+    }
 
     const auto notifSettings = parsed["Notifications"];
     taskConfig.enableNotifications = notifSettings["enable_notifications"].value_or(taskConfig.enableNotifications);
@@ -116,7 +175,50 @@ static TaskConfig readSettings(const toml::parse_result& parsed) {
     return taskConfig;
 }
 
+static std::string computeFingerprint(const TaskConfig& config, const std::vector<Course>& courses) {
+    std::uint64_t hash = FNV1A_OFFSET_BASIS;
+    auto mix = [&](const std::string_view value) {
+        hash = fnv1a(value, hash);
+        hash = fnv1a("\x1F", hash); // Field separator so that "12" + "3" differs from "1" + "23"
+    };
+
+    mix(config.cwid);
+    mix(config.termCode);
+
+    for (const Course& course : courses) {
+        mix(course.primary.value);
+        for (const CRN& backup : course.backups) {
+            mix(backup.value);
+        }
+        mix(course.drop.value);
+        mix(course.waitlist ? "1" : "0");
+        mix(course.prioritizeOpenSeats ? "1" : "0");
+    }
+
+    return fmt::format("{:016x}", hash);
+}
+
+static std::pair<TaskConfig, std::vector<Course>> loadParsed(const toml::parse_result& parsed) {
+    std::pair<TaskConfig, std::vector<Course>> loaded{readSettings(parsed), readCourses(parsed)};
+    loaded.first.fingerprint = computeFingerprint(loaded.first, loaded.second);
+    return loaded;
+}
+
 std::pair<TaskConfig, std::vector<Course>> ConfigLoader::load(const std::string_view configPath) {
-    const auto parseResult = toml::parse_file(configPath);
-    return {readSettings(parseResult), readCourses(parseResult)};
+    return loadParsed(toml::parse_file(configPath));
+}
+
+std::pair<TaskConfig, std::vector<Course>> ConfigLoader::loadFromString(const std::string_view contents) {
+    return loadParsed(toml::parse(contents));
+}
+
+std::string ConfigLoader::readCwid(const std::string_view contents) {
+    const toml::parse_result parsed = toml::parse(contents);
+
+    std::string cwid = parsed["Login"]["cwid"].value_or("");
+    if (cwid.empty()) {
+        throw std::runtime_error{"Missing CWID in config file."};
+    }
+
+    return cwid;
 }
\ No newline at end of file
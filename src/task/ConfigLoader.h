@@ -4,12 +4,17 @@
 #include "task/TaskConfig.h"
 #include "util/Course.h"
 
+#include <string>
 #include <string_view>
 #include <utility>
 #include <vector>
 
 struct ConfigLoader {
     static std::pair<TaskConfig, std::vector<Course>> load(std::string_view configPath);
+    static std::pair<TaskConfig, std::vector<Course>> loadFromString(std::string_view contents);
+
+    // Only parses the CWID, without validating the rest of the config or contacting the server.
+    static std::string readCwid(std::string_view contents);
 };
 
 #endif // CONFIGLOADER_H
\ No newline at end of file
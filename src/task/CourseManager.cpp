@@ -9,9 +9,10 @@
 
 #include <algorithm>
 #include <ranges>
+#include <utility>
 
 namespace {
-std::string_view getCourseSectionWarning(const std::string_view termCode, const std::string_view displayName) {
+std::string_view getCourseSectionWarning(const std::string_view termCode, const std::string_view sectionNumber) {
     using namespace std::literals;
 
     static constexpr std::pair<std::string_view, std::string_view> foothillSectionCodes[] = {
@@ -43,8 +44,6 @@ std::string_view getCourseSectionWarning(const std::string_view termCode, const
         {"W"sv, "This course is only open to students in the FLOW program."sv}
     };
 
-    const std::string_view sectionNumber = displayName.substr(displayName.rfind(", ") + 2);
-
     // Foothill
     if (termCode.back() == '1') {
         for (auto [code, definition] : foothillSectionCodes) {
@@ -138,16 +137,27 @@ CourseManager::CourseManager(std::vector<Course>&& courses) : m_courses(std::mov
 
 void CourseManager::populateCourseDetails(cpr::Session& session, const std::string& termCode) {
     std::vector<std::string> invalidCourses;
+    m_catalog = SectionCatalog::load(termCode);
 
     auto populateDetails = [&](CRN& crn) {
-        if (crn.empty()) {
+        // Details may have already been restored from a checkpoint
+        if (crn.empty() || !crn.courseCode.empty()) {
+            return;
+        }
+
+        // Sections added after the catalog was downloaded still go through the portal
+        if (const auto section = m_catalog ? m_catalog->findByCrn(crn.value) : std::nullopt) {
+            crn.courseCode = section->courseCode;
+            crn.section = section->section;
+            crn.sectionWarning = getCourseSectionWarning(termCode, crn.section);
             return;
         }
 
         try {
             const rapidjson::Document courseData = getCourseData(session, termCode, crn);
             crn.courseCode = extractCourseCode(courseData);
-            crn.sectionWarning = getCourseSectionWarning(termCode, courseData["responseDisplay"].GetString());
+            crn.section = std::string{courseData["sequenceNumber"].GetString(), courseData["sequenceNumber"].GetStringLength()};
+            crn.sectionWarning = getCourseSectionWarning(termCode, crn.section);
         } catch (const UnrecoverableException&) { // Always returns HTTP 500 upon error
             invalidCourses.push_back(crn.value);
         }
@@ -166,6 +176,29 @@ void CourseManager::populateCourseDetails(cpr::Session& session, const std::stri
     }
 }
 
+void CourseManager::restoreCourseDetails(const std::string& crn, std::string courseCode, std::string section,
+        const std::string_view termCode) {
+    for (Course& course : m_courses) {
+        for (CRN* candidate : {&course.primary, &course.drop}) {
+            if (*candidate == crn) {
+                candidate->courseCode = std::move(courseCode);
+                candidate->section = std::move(section);
+                candidate->sectionWarning = getCourseSectionWarning(termCode, candidate->section);
+                return;
+            }
+        }
+
+        for (CRN& backup : course.backups) {
+            if (backup == crn) {
+                backup.courseCode = std::move(courseCode);
+                backup.section = std::move(section);
+                backup.sectionWarning = getCourseSectionWarning(termCode, backup.section);
+                return;
+            }
+        }
+    }
+}
+
 void CourseManager::displayCourses(const TaskLogger& logger) const {
     auto printWarning = [&](const CRN& crn) {
         if (crn.sectionWarning.empty()) {
@@ -188,10 +221,28 @@ void CourseManager::displayCourses(const TaskLogger& logger) const {
         if (!course.drop.empty()) {
             logger.info("{} (Dropping for {})", course.drop, course.primary.value);
         }
+
+        if (course.backups.empty() && m_catalog) {
+            // The catalog stores CRNs as numbers, so they're compared that way and padded back to the primary's width
+            const auto primary = m_catalog->findByCrn(course.primary.value);
+            const std::size_t width = course.primary.value.size();
+
+            std::vector<std::string> otherSections;
+            for (const CatalogSection& section : m_catalog->findByCourse(course.primary.courseCode)) {
+                if (!primary || section.crn != primary->crn) {
+                    otherSections.push_back(fmt::format("{:0{}} (section {})", section.crn, width, section.section));
+                }
+            }
+
+            if (!otherSections.empty()) {
+                logger.info("Other sections of {} that could be backups: {}", course.primary.courseCode,
+                    fmt::join(otherSections, ", "));
+            }
+        }
     }
 }
 
-bool CourseManager::canWaitlistCourse(const std::string& crn) const {
+bool CourseManager::canWaitlistCourse(const std::string_view crn) const {
     return m_waitlists.contains(crn);
 }
 
@@ -204,7 +255,11 @@ void CourseManager::enqueueNotification(std::string title, std::string message)
     m_notificationQueue.emplace_back(std::move(title), std::move(message));
 }
 
-std::unordered_set<std::string>& CourseManager::getRegistrationQueue() noexcept {
+StringSet& CourseManager::getRegistrationQueue() noexcept {
+    return m_registrationQueue;
+}
+
+const StringSet& CourseManager::getRegistrationQueue() const noexcept {
     return m_registrationQueue;
 }
 
@@ -212,38 +267,90 @@ void CourseManager::enqueueCRN(const std::string& crn) {
     m_registrationQueue.insert(crn);
 }
 
-void CourseManager::dequeueCRN(const std::string& crn) {
-    m_registrationQueue.erase(crn);
+void CourseManager::dequeueCRN(const std::string_view crn) {
+    if (const auto it = m_registrationQueue.find(crn); it != m_registrationQueue.end()) {
+        m_registrationQueue.erase(it);
+    }
+}
+
+void CourseManager::removeCourse(const std::string_view crn) {
+    if (eraseCourse(crn)) {
+        m_removedCrns.emplace_back(crn);
+    }
+}
+
+void CourseManager::completeCourse(const std::string_view crn) {
+    if (eraseCourse(crn)) {
+        m_completedCrns.emplace_back(crn);
+    }
+}
+
+void CourseManager::restoreProgress(std::vector<std::string> completedCrns, std::vector<std::string> removedCrns) {
+    for (const std::string& crn : completedCrns) {
+        eraseCourse(crn);
+    }
+
+    for (const std::string& crn : removedCrns) {
+        eraseCourse(crn);
+    }
+
+    m_completedCrns = std::move(completedCrns);
+    m_removedCrns = std::move(removedCrns);
+}
+
+const std::vector<std::string>& CourseManager::getCompletedCrns() const noexcept {
+    return m_completedCrns;
 }
 
-void CourseManager::removeCourse(const std::string& crn) {
+const std::vector<std::string>& CourseManager::getRemovedCrns() const noexcept {
+    return m_removedCrns;
+}
+
+void CourseManager::setUnconfirmedCrns(std::vector<std::string> crns) noexcept {
+    m_unconfirmedCrns = std::move(crns);
+}
+
+std::vector<std::string> CourseManager::takeUnconfirmedCrns() noexcept {
+    return std::exchange(m_unconfirmedCrns, {});
+}
+
+bool CourseManager::eraseCourse(const std::string_view crn) {
     const auto it = std::ranges::find_if(m_courses, [&](const Course& course) {
         return course == crn;
     });
 
-    if (it != m_courses.end()) {
-        m_waitlists.erase(it->primary.value);
-        for (const CRN& backup : it->backups) {
-            m_waitlists.erase(backup.value);
-        }
+    if (it == m_courses.end()) {
+        return false;
+    }
 
-        m_courses.erase(it);
+    m_waitlists.erase(it->primary.value);
+    for (const CRN& backup : it->backups) {
+        m_waitlists.erase(backup.value);
     }
+
+    m_courses.erase(it);
+    return true;
 }
 
 std::vector<Course>& CourseManager::getCourses() noexcept {
     return m_courses;
 }
 
+const std::vector<Course>& CourseManager::getCourses() const noexcept {
+    return m_courses;
+}
+
 void CourseManager::enqueueDrop(const std::string& crn) {
     m_dropQueue.insert(crn);
 }
 
-void CourseManager::dequeueDrop(const std::string& crn) {
-    m_dropQueue.erase(crn);
+void CourseManager::dequeueDrop(const std::string_view crn) {
+    if (const auto it = m_dropQueue.find(crn); it != m_dropQueue.end()) {
+        m_dropQueue.erase(it);
+    }
 }
 
-std::unordered_set<std::string>& CourseManager::getDropQueue() noexcept {
+StringSet& CourseManager::getDropQueue() noexcept {
     return m_dropQueue;
 }
 
@@ -255,6 +362,10 @@ rapidjson::Document& CourseManager::getOldModel() noexcept {
     return m_oldModel;
 }
 
+std::string& CourseManager::getOldModelBuffer() noexcept {
+    return m_oldModelBuffer;
+}
+
 void CourseManager::resetFailedCount() noexcept {
     m_failedCourses = 0;
 }
@@ -267,6 +378,14 @@ bool CourseManager::hasFailures() const noexcept {
     return m_failedCourses != 0;
 }
 
+int CourseManager::getFailedCount() const noexcept {
+    return m_failedCourses;
+}
+
+void CourseManager::restoreFailedCount(const int count) noexcept {
+    m_failedCourses = count;
+}
+
 void CourseManager::clearQueues() noexcept {
     m_registrationQueue.clear();
     m_dropQueue.clear();
@@ -275,3 +394,7 @@ void CourseManager::clearQueues() noexcept {
 rapidjson::MemoryPoolAllocator<>& CourseManager::getAllocator() noexcept {
     return m_allocator;
 }
+
+rapidjson::MemoryPoolAllocator<>& CourseManager::getModelAllocator() noexcept {
+    return m_modelAllocator;
+}
@@ -1,15 +1,18 @@
 #ifndef COURSEMANAGER_H
 #define COURSEMANAGER_H
 
+#include "data/SectionCatalog.h"
 #include "task/TaskLogger.h"
 #include "util/Course.h"
+#include "util/Utility.h"
 
 #include <cpr/cpr.h>
 #include <rapidjson/document.h>
 
 #include <atomic>
+#include <memory>
 #include <string>
-#include <unordered_set>
+#include <string_view>
 #include <vector>
 
 class CourseManager {
@@ -17,45 +20,71 @@ public:
     CourseManager() = default;
     explicit CourseManager(std::vector<Course>&& courses);
 
+    // Uses the term's section catalog when there is one, only asking the portal about CRNs it doesn't have.
     void populateCourseDetails(cpr::Session& session, const std::string& termCode);
+    void restoreCourseDetails(const std::string& crn, std::string courseCode, std::string section,
+        std::string_view termCode);
     void displayCourses(const TaskLogger& logger) const;
-    bool canWaitlistCourse(const std::string& crn) const;
+    bool canWaitlistCourse(std::string_view crn) const;
 
     std::vector<std::pair<std::string, std::string>>& getNotificationQueue();
     void enqueueNotification(std::string title, std::string message);
 
-    std::unordered_set<std::string>& getRegistrationQueue() noexcept;
+    StringSet& getRegistrationQueue() noexcept;
+    const StringSet& getRegistrationQueue() const noexcept;
     void enqueueCRN(const std::string& crn);
-    void dequeueCRN(const std::string& crn);
-    void removeCourse(const std::string& crn);
+    void dequeueCRN(std::string_view crn);
+    void removeCourse(std::string_view crn);
+    void completeCourse(std::string_view crn);
+    void restoreProgress(std::vector<std::string> completedCrns, std::vector<std::string> removedCrns);
+    const std::vector<std::string>& getCompletedCrns() const noexcept;
+    const std::vector<std::string>& getRemovedCrns() const noexcept;
+    // CRNs that were being submitted when the task last stopped, so might already be registered
+    void setUnconfirmedCrns(std::vector<std::string> crns) noexcept;
+    std::vector<std::string> takeUnconfirmedCrns() noexcept;
     std::vector<Course>& getCourses() noexcept;
+    const std::vector<Course>& getCourses() const noexcept;
 
     void enqueueDrop(const std::string& crn);
-    void dequeueDrop(const std::string& crn);
-    std::unordered_set<std::string>& getDropQueue() noexcept;
+    void dequeueDrop(std::string_view crn);
+    StringSet& getDropQueue() noexcept;
     void setOldModel(rapidjson::Document&& model) noexcept;
     rapidjson::Document& getOldModel() noexcept;
+    // The class registration page the old model is parsed in place from
+    std::string& getOldModelBuffer() noexcept;
 
     void resetFailedCount() noexcept;
     void incrementFailedCount() noexcept;
     bool hasFailures() const noexcept;
+    int getFailedCount() const noexcept;
+    void restoreFailedCount(int count) noexcept;
     void clearQueues() noexcept;
 
     rapidjson::MemoryPoolAllocator<>& getAllocator() noexcept;
+    // Separate from the cart's allocator so that the old model can be fetched while the cart is being filled
+    rapidjson::MemoryPoolAllocator<>& getModelAllocator() noexcept;
 
 private:
+    bool eraseCourse(std::string_view crn);
+
     std::vector<Course> m_courses;
-    std::unordered_set<std::string> m_waitlists;
+    std::shared_ptr<const SectionCatalog> m_catalog;
+    StringSet m_waitlists;
+    std::vector<std::string> m_completedCrns;
+    std::vector<std::string> m_removedCrns;
+    std::vector<std::string> m_unconfirmedCrns;
 
     std::vector<std::pair<std::string, std::string>> m_notificationQueue;
 
-    std::unordered_set<std::string> m_registrationQueue;
-    std::unordered_set<std::string> m_dropQueue;
+    StringSet m_registrationQueue;
+    StringSet m_dropQueue;
 
     std::atomic_int m_failedCourses{0};
 
     rapidjson::MemoryPoolAllocator<> m_allocator;
-    rapidjson::Document m_oldModel{&m_allocator};
+    rapidjson::MemoryPoolAllocator<> m_modelAllocator;
+    std::string m_oldModelBuffer;
+    rapidjson::Document m_oldModel{&m_modelAllocator};
 };
 
 #endif // COURSEMANAGER_H
\ No newline at end of file
@@ -0,0 +1,218 @@
+#include "task/FailoverMonitor.h"
+
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+#include <fstream>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+namespace {
+constexpr std::chrono::milliseconds STANDBY_POLL_INTERVAL{250};
+
+long long getProcessId() {
+#if defined(_WIN32)
+    return static_cast<long long>(GetCurrentProcessId());
+#else
+    return static_cast<long long>(::getpid());
+#endif
+}
+} // namespace
+
+FailoverMonitor::FailoverMonitor(const InstanceRole role, std::filesystem::path stateDirectory)
+    : m_role{role},
+      m_lockPath{stateDirectory / "primary.lock"},
+      m_heartbeatPath{stateDirectory / "primary.heartbeat"} {
+    std::filesystem::create_directories(stateDirectory);
+}
+
+FailoverMonitor::~FailoverMonitor() {
+    stop();
+
+    if (m_future.valid()) {
+        m_future.wait();
+    }
+
+    unlock();
+}
+
+void FailoverMonitor::start(std::function<void()> onActivated, std::function<void()> onDemoted) {
+    m_onActivated = std::move(onActivated);
+    m_onDemoted = std::move(onDemoted);
+
+    if (m_role == InstanceRole::Primary) {
+        if (!tryLock()) {
+            throw std::runtime_error{fmt::format(
+                "Another DARE instance is already the primary for {}. Start this one with --role standby instead.",
+                m_lockPath.parent_path().string())};
+        }
+
+        writeHeartbeat();
+        m_active.store(true);
+        spdlog::get("console")->info("Running as the primary instance.");
+    } else {
+        spdlog::get("console")->info("Running as a standby instance. Tasks will be prepared but not registered.");
+    }
+
+    m_future = std::async(std::launch::async, [this] {
+        run();
+    });
+}
+
+void FailoverMonitor::stop() noexcept {
+    m_stopRequested.store(true);
+    m_stopCv.notify_all();
+}
+
+bool FailoverMonitor::isActive() const noexcept {
+    return m_active.load();
+}
+
+bool FailoverMonitor::confirmActive() const {
+    if (!m_active.load()) {
+        return false;
+    }
+
+    // The heartbeat is only ever replaced whole, so one that can't be read means something is wrong with the state
+    // directory, and this instance can't show it's still the one in charge
+    const auto heartbeat = readHeartbeat();
+    return heartbeat && heartbeat->processId == getProcessId();
+}
+
+InstanceRole FailoverMonitor::getRole() const noexcept {
+    return m_role;
+}
+
+#if defined(_WIN32)
+bool FailoverMonitor::tryLock() {
+    if (m_lockHandle != nullptr) {
+        return true;
+    }
+
+    // Opening without any sharing fails while another process has the file open
+    HANDLE handle = CreateFileW(m_lockPath.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_ALWAYS,
+        FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    m_lockHandle = handle;
+    return true;
+}
+
+void FailoverMonitor::unlock() noexcept {
+    if (m_lockHandle != nullptr) {
+        CloseHandle(static_cast<HANDLE>(m_lockHandle));
+        m_lockHandle = nullptr;
+    }
+}
+#else
+bool FailoverMonitor::tryLock() {
+    if (m_lockFd < 0) {
+        m_lockFd = ::open(m_lockPath.c_str(), O_RDWR | O_CREAT, 0600);
+        if (m_lockFd < 0) {
+            return false;
+        }
+    }
+
+    // The kernel releases the lock if the holder exits or crashes
+    return ::flock(m_lockFd, LOCK_EX | LOCK_NB) == 0;
+}
+
+void FailoverMonitor::unlock() noexcept {
+    if (m_lockFd >= 0) {
+        ::close(m_lockFd);
+        m_lockFd = -1;
+    }
+}
+#endif
+
+void FailoverMonitor::writeHeartbeat() const {
+    // Per process, since a standby taking over and a hung primary waking up can both be writing at once
+    std::filesystem::path tempPath = m_heartbeatPath;
+    tempPath += fmt::format(".{}.tmp", getProcessId());
+
+    {
+        std::ofstream file{tempPath, std::ios::trunc};
+        file << getProcessId() << ' ' << std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count() << '\n';
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, m_heartbeatPath, ec);
+}
+
+std::optional<FailoverMonitor::Heartbeat> FailoverMonitor::readHeartbeat() const {
+    std::ifstream file{m_heartbeatPath};
+
+    long long processId = 0;
+    long long timeMs = 0;
+    if (!(file >> processId >> timeMs)) {
+        return std::nullopt;
+    }
+
+    return Heartbeat{processId, std::chrono::system_clock::time_point{std::chrono::milliseconds{timeMs}}};
+}
+
+void FailoverMonitor::activate(const std::string_view reason) {
+    const auto lastHeartbeat = readHeartbeat();
+
+    // Claim the heartbeat first so that a hung primary stands down if it ever wakes up
+    writeHeartbeat();
+    m_active.store(true);
+
+    const auto console = spdlog::get("console");
+    if (lastHeartbeat) {
+        const auto sinceHeartbeat = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now() - lastHeartbeat->time);
+        console->warn("Taking over as the active instance ({}). Last primary heartbeat was {} ms ago.",
+            reason, sinceHeartbeat.count());
+    } else {
+        console->warn("Taking over as the active instance ({}).", reason);
+    }
+
+    if (m_onActivated) {
+        m_onActivated();
+    }
+}
+
+void FailoverMonitor::run() {
+    const long long processId = getProcessId();
+
+    while (!m_stopRequested.load()) {
+        if (m_active.load()) {
+            if (const auto heartbeat = readHeartbeat(); heartbeat && heartbeat->processId != processId) {
+                m_active.store(false);
+                spdlog::get("console")->error("Process {} took over as the active instance. Standing down.",
+                    heartbeat->processId);
+
+                if (m_onDemoted) {
+                    m_onDemoted();
+                }
+
+                return;
+            }
+
+            // After a heartbeat takeover the hung primary may still hold the lock, so keep trying for it
+            tryLock();
+            writeHeartbeat();
+        } else if (tryLock()) {
+            activate("primary lock released");
+        } else if (const auto heartbeat = readHeartbeat();
+                !heartbeat || std::chrono::system_clock::now() - heartbeat->time > HEARTBEAT_TIMEOUT) {
+            activate("primary heartbeat timed out");
+        }
+
+        const auto interval = m_active.load() ? HEARTBEAT_INTERVAL : STANDBY_POLL_INTERVAL;
+        std::unique_lock lock{m_stopMutex};
+        m_stopCv.wait_for(lock, interval, [this] {
+            return m_stopRequested.load();
+        });
+    }
+}
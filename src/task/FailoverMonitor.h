@@ -0,0 +1,80 @@
+#ifndef FAILOVERMONITOR_H
+#define FAILOVERMONITOR_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <string_view>
+
+enum class InstanceRole {
+    Primary,
+    Standby
+};
+
+// Coordinates an active/standby pair of DARE processes sharing a state directory.
+//
+// The active instance holds an exclusive lock on `primary.lock` and rewrites `primary.heartbeat` every
+// HEARTBEAT_INTERVAL. The standby takes over as soon as it can grab the lock (the primary exited or crashed)
+// or the heartbeat is older than HEARTBEAT_TIMEOUT (the primary hung). Taking over rewrites the heartbeat with
+// the standby's process ID, which tells a hung primary that comes back to stand down.
+class FailoverMonitor {
+public:
+    static constexpr std::chrono::milliseconds HEARTBEAT_INTERVAL{500};
+    static constexpr std::chrono::milliseconds HEARTBEAT_TIMEOUT{2000};
+
+    FailoverMonitor(InstanceRole role, std::filesystem::path stateDirectory);
+    ~FailoverMonitor();
+
+    FailoverMonitor(const FailoverMonitor&) = delete;
+    FailoverMonitor& operator=(const FailoverMonitor&) = delete;
+
+    // Throws if started as the primary while another instance already holds the lock.
+    void start(std::function<void()> onActivated, std::function<void()> onDemoted);
+    void stop() noexcept;
+
+    [[nodiscard]] bool isActive() const noexcept;
+    // Like isActive(), but also reads the heartbeat file instead of waiting up to HEARTBEAT_INTERVAL for the next
+    // check to notice a takeover. False if the heartbeat can't be read. For right before doing something only the
+    // active instance may do.
+    [[nodiscard]] bool confirmActive() const;
+    [[nodiscard]] InstanceRole getRole() const noexcept;
+
+private:
+    struct Heartbeat {
+        long long processId = 0;
+        std::chrono::system_clock::time_point time;
+    };
+
+    bool tryLock();
+    void unlock() noexcept;
+    void writeHeartbeat() const;
+    [[nodiscard]] std::optional<Heartbeat> readHeartbeat() const;
+    void activate(std::string_view reason);
+    void run();
+
+    const InstanceRole m_role;
+    const std::filesystem::path m_lockPath;
+    const std::filesystem::path m_heartbeatPath;
+
+    std::atomic<bool> m_active{false};
+    std::atomic<bool> m_stopRequested{false};
+    std::mutex m_stopMutex;
+    std::condition_variable m_stopCv;
+    std::future<void> m_future;
+
+    std::function<void()> m_onActivated;
+    std::function<void()> m_onDemoted;
+
+#if defined(_WIN32)
+    void* m_lockHandle = nullptr;
+#else
+    int m_lockFd = -1;
+#endif
+};
+
+#endif // FAILOVERMONITOR_H
@@ -0,0 +1,311 @@
+#include "task/LatencyMode.h"
+
+#include <fmt/format.h>
+#include <fmt/ranges.h>
+
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+
+namespace {
+// Shared by every task in latency-critical mode at the same time
+struct ProcessState {
+    std::mutex mutex;
+    std::optional<cpu_set_t> originalMask; // The process's CPUs before any were reserved
+    std::set<int> reservedCores;
+    std::set<pid_t> reservedThreads;
+    std::map<pid_t, cpu_set_t> movedThreads; // Masks from before they were moved off the reserved cores
+    int memoryLocks = 0;
+};
+
+ProcessState& processState() {
+    static ProcessState state;
+    return state;
+}
+
+pid_t currentThreadId() {
+    return static_cast<pid_t>(syscall(SYS_gettid));
+}
+
+std::vector<pid_t> listThreads() {
+    std::vector<pid_t> threads;
+
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator{"/proc/self/task", ec}) {
+        const std::string name = entry.path().filename().string();
+
+        pid_t thread = 0;
+        if (std::from_chars(name.data(), name.data() + name.size(), thread).ec == std::errc{}) {
+            threads.push_back(thread);
+        }
+    }
+
+    return threads;
+}
+
+// Also picks up threads started since the last call
+void moveOtherThreads(ProcessState& state) {
+    cpu_set_t allowed = *state.originalMask;
+    for (const int core : state.reservedCores) {
+        CPU_CLR(core, &allowed);
+    }
+
+    for (const pid_t thread : listThreads()) {
+        if (state.reservedThreads.contains(thread)) {
+            continue;
+        }
+
+        if (!state.movedThreads.contains(thread)) {
+            cpu_set_t mask;
+            if (sched_getaffinity(thread, sizeof(mask), &mask) != 0) {
+                continue; // Already exited
+            }
+
+            state.movedThreads.emplace(thread, mask);
+        }
+
+        sched_setaffinity(thread, sizeof(allowed), &allowed);
+    }
+}
+
+// Highest-numbered core that isn't reserved yet, as long as one is left for everything else
+int pickCore(const ProcessState& state) {
+    if (CPU_COUNT(&*state.originalMask) - static_cast<int>(state.reservedCores.size()) < 2) {
+        return -1;
+    }
+
+    for (int core = CPU_SETSIZE - 1; core >= 0; --core) {
+        if (CPU_ISSET(core, &*state.originalMask) && !state.reservedCores.contains(core)) {
+            return core;
+        }
+    }
+
+    return -1;
+}
+
+// Touches the stack registration runs on, so its first use doesn't fault
+void prefaultStack() {
+    static constexpr std::size_t STACK_PREFAULT = 256 * 1024;
+    static constexpr std::size_t PAGE_SIZE = 4096;
+
+    [[maybe_unused]] volatile char buffer[STACK_PREFAULT];
+    for (std::size_t i = 0; i < STACK_PREFAULT; i += PAGE_SIZE) {
+        buffer[i] = 0;
+    }
+}
+} // namespace
+#endif
+
+LatencyMode::~LatencyMode() {
+    restore(false);
+}
+
+void LatencyMode::enter(const TaskLogger& logger) {
+    if (m_active) {
+        return;
+    }
+
+#if defined(__linux__)
+    static constexpr int FIFO_PRIORITY = 10; // Ahead of every normal thread, well behind the kernel's own
+    static constexpr int RAISED_NICE = -10;
+
+    ProcessState& state = processState();
+    std::lock_guard lock{state.mutex};
+
+    m_active = true;
+    m_thread = currentThreadId();
+    std::vector<std::string> applied;
+
+    m_policy = sched_getscheduler(m_thread);
+    sched_getparam(m_thread, &m_param);
+    if (const sched_param fifo{.sched_priority = FIFO_PRIORITY}; sched_setscheduler(m_thread, SCHED_FIFO, &fifo) == 0) {
+        m_raisedPolicy = true;
+        applied.push_back(fmt::format("SCHED_FIFO priority {}", FIFO_PRIORITY));
+    } else {
+        errno = 0;
+        m_nice = getpriority(PRIO_PROCESS, static_cast<id_t>(m_thread));
+        if (errno == 0 && setpriority(PRIO_PROCESS, static_cast<id_t>(m_thread), RAISED_NICE) == 0) {
+            m_raisedNice = true;
+            applied.push_back(fmt::format("nice {}", RAISED_NICE));
+        }
+    }
+
+    if (!state.originalMask) {
+        if (cpu_set_t mask; sched_getaffinity(getpid(), sizeof(mask), &mask) == 0) {
+            state.originalMask = mask;
+        }
+    }
+
+    if (state.originalMask && sched_getaffinity(m_thread, sizeof(m_mask), &m_mask) == 0) {
+        // Moved off an earlier task's core, so its mask from before that is the one to go back to
+        if (const auto moved = state.movedThreads.find(m_thread); moved != state.movedThreads.end()) {
+            m_mask = moved->second;
+            state.movedThreads.erase(moved);
+        }
+
+        cpu_set_t pinned;
+        CPU_ZERO(&pinned);
+        if (const int core = pickCore(state); core >= 0) {
+            CPU_SET(core, &pinned);
+            if (sched_setaffinity(m_thread, sizeof(pinned), &pinned) == 0) {
+                m_core = core;
+                state.reservedCores.insert(core);
+                state.reservedThreads.insert(m_thread);
+                moveOtherThreads(state);
+                applied.push_back(fmt::format("pinned to CPU {}", core));
+            }
+        }
+    }
+
+    if (state.memoryLocks > 0) {
+        m_lockedMemory = true;
+    } else {
+        // Locking future mappings under a limit would make allocations fail once it's reached
+        rlimit limit{};
+        const bool unlimited = getrlimit(RLIMIT_MEMLOCK, &limit) == 0 && limit.rlim_cur == RLIM_INFINITY;
+        m_lockedMemory = mlockall(unlimited ? MCL_CURRENT | MCL_FUTURE : MCL_CURRENT) == 0;
+    }
+
+    if (m_lockedMemory) {
+        ++state.memoryLocks;
+        applied.emplace_back("memory locked");
+    }
+
+    prefaultStack();
+
+    if (applied.empty()) {
+        logger.warn("Couldn't apply any of latency-critical mode. It needs CAP_SYS_NICE and CAP_IPC_LOCK (or a "
+            "higher RLIMIT_MEMLOCK) and more than one CPU.");
+        return;
+    }
+
+    logger.info("Entered latency-critical mode ({}).", fmt::join(applied, ", "));
+#else
+    logger.warn("Latency-critical mode is only supported on Linux.");
+#endif
+}
+
+void LatencyMode::leave(const TaskLogger& logger) {
+    if (!m_active) {
+        return;
+    }
+
+#if defined(__linux__)
+    const bool onOwnThread = currentThreadId() == m_thread;
+#else
+    const bool onOwnThread = true;
+#endif
+
+    restore(onOwnThread);
+    logger.info("Left latency-critical mode.");
+}
+
+bool LatencyMode::isActive() const noexcept {
+    return m_active;
+}
+
+void LatencyMode::releaseCurrentThread() noexcept {
+#if defined(__linux__)
+    ProcessState& state = processState();
+    std::lock_guard lock{state.mutex};
+
+    const pid_t thread = currentThreadId();
+    if (state.reservedCores.empty() || state.reservedThreads.contains(thread)) {
+        return;
+    }
+
+    if (sched_getscheduler(thread) == SCHED_FIFO) {
+        const sched_param normal{.sched_priority = 0};
+        sched_setscheduler(thread, SCHED_OTHER, &normal);
+    }
+
+    // Back to the process's own nice value, in case the thread was started with the raised one
+    errno = 0;
+    const int processNice = getpriority(PRIO_PROCESS, static_cast<id_t>(getpid()));
+    if (errno == 0 && getpriority(PRIO_PROCESS, static_cast<id_t>(thread)) < processNice) {
+        setpriority(PRIO_PROCESS, static_cast<id_t>(thread), processNice);
+    }
+
+    cpu_set_t allowed = *state.originalMask;
+    for (const int core : state.reservedCores) {
+        CPU_CLR(core, &allowed);
+    }
+
+    // Not recorded in movedThreads. Released threads are short-lived and already off the reserved cores, and
+    // restoring a thread that has exited would act on whatever now has its ID.
+    sched_setaffinity(thread, sizeof(allowed), &allowed);
+#endif
+}
+
+void LatencyMode::restore(const bool onOwnThread) noexcept {
+    if (!m_active) {
+        return;
+    }
+
+    m_active = false;
+
+#if defined(__linux__)
+    ProcessState& state = processState();
+    std::lock_guard lock{state.mutex};
+
+    if (m_raisedPolicy && onOwnThread) {
+        sched_setscheduler(m_thread, m_policy, &m_param);
+    }
+    m_raisedPolicy = false;
+
+    if (m_raisedNice && onOwnThread) {
+        setpriority(PRIO_PROCESS, static_cast<id_t>(m_thread), m_nice);
+    }
+    m_raisedNice = false;
+
+    if (m_core >= 0) {
+        if (onOwnThread) {
+            sched_setaffinity(m_thread, sizeof(m_mask), &m_mask);
+        }
+
+        state.reservedCores.erase(m_core);
+        state.reservedThreads.erase(m_thread);
+        m_core = -1;
+
+        if (state.reservedCores.empty()) {
+            // Thread IDs are system-wide, so one that has since exited could belong to anything by now
+            try {
+                const std::vector<pid_t> threads = listThreads();
+                for (const auto& [thread, mask] : state.movedThreads) {
+                    if (std::ranges::find(threads, thread) != threads.end()) {
+                        sched_setaffinity(thread, sizeof(mask), &mask);
+                    }
+                }
+            } catch (const std::exception&) {}
+
+            state.movedThreads.clear();
+        } else {
+            try {
+                moveOtherThreads(state); // Frees up this task's core for everything else
+            } catch (const std::exception&) {}
+        }
+    }
+
+    if (m_lockedMemory) {
+        if (--state.memoryLocks == 0) {
+            munlockall();
+        }
+
+        m_lockedMemory = false;
+    }
+#endif
+}
@@ -0,0 +1,65 @@
+#ifndef LATENCYMODE_H
+#define LATENCYMODE_H
+
+#include "task/TaskLogger.h"
+
+#include <chrono>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/types.h>
+#endif
+
+// Gives a task's thread the machine's full attention around registration opening (latency_critical_mode, Linux only):
+// real-time scheduling priority (or a lower nice value without the permissions for it), a core of its own that every
+// other thread in the process (logging, notifications, other tasks) is moved off, and the process's memory locked and
+// prefaulted. Each part is applied as far as the process is allowed to, and undone on leave().
+//
+// Threads the task starts inherit the core and priority. The ones on the critical path keep them, but side work off it
+// calls releaseCurrentThread() first, since real-time threads of the same priority on one core only run one at a time.
+class LatencyMode {
+public:
+    // The window around the registration time that the mode covers
+    static constexpr std::chrono::seconds LEAD{10};
+    static constexpr std::chrono::seconds LINGER{30};
+
+    LatencyMode() = default;
+    ~LatencyMode();
+
+    LatencyMode(const LatencyMode&) = delete;
+    LatencyMode& operator=(const LatencyMode&) = delete;
+
+    // Applies to the calling thread, and has to be left on the same thread
+    void enter(const TaskLogger& logger);
+    void leave(const TaskLogger& logger);
+    [[nodiscard]] bool isActive() const noexcept;
+
+    // Puts the calling thread back on normal scheduling and off every reserved core. Does nothing when no task is in
+    // the mode.
+    static void releaseCurrentThread() noexcept;
+
+private:
+    // Only touches the task's thread itself from that thread. The destructor can't, since the thread has usually
+    // exited by then and its ID might belong to another one, so it only gives back what's shared by the process.
+    void restore(bool onOwnThread) noexcept;
+
+    bool m_active = false;
+
+#if defined(__linux__)
+    pid_t m_thread = 0;
+
+    bool m_raisedPolicy = false;
+    int m_policy = SCHED_OTHER;
+    sched_param m_param{};
+
+    bool m_raisedNice = false;
+    int m_nice = 0;
+
+    int m_core = -1;
+    cpu_set_t m_mask{};
+
+    bool m_lockedMemory = false;
+#endif
+};
+
+#endif // LATENCYMODE_H
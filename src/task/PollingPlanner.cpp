@@ -0,0 +1,179 @@
+#include "task/PollingPlanner.h"
+#include "data/SeatHistory.h"
+#include "util/Utility.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+static_assert(PollingPlanner::LOOKBACK <= SeatHistory::RETENTION);
+
+namespace {
+// Gaps longer than this mean DARE wasn't running, so they don't count as time spent watching
+constexpr std::chrono::seconds MAX_OBSERVATION_GAP{60};
+
+// How many hours of the overall rate each bin starts out with before its own history takes over
+constexpr double PRIOR_HOURS = 1.0;
+
+// Checks are spread +/- a third around the planned interval, like the old 3-6 seconds around 4.5
+constexpr double JITTER = 1.0 / 3.0;
+
+std::int64_t getDay(const std::chrono::system_clock::time_point time) {
+    return std::chrono::floor<std::chrono::days>(time).time_since_epoch().count();
+}
+
+std::size_t getBin(const std::chrono::system_clock::time_point time) {
+    const auto sinceMidnight = time.time_since_epoch() % std::chrono::days{1};
+    return static_cast<std::size_t>(sinceMidnight / PollingPlanner::BIN_SIZE) % PollingPlanner::BIN_COUNT;
+}
+
+bool isAddable(const CourseStatus status) {
+    return status == CourseStatus::Open || status == CourseStatus::WaitlistOpen;
+}
+
+struct BinHistory {
+    std::array<double, PollingPlanner::BIN_COUNT> openings{};
+    std::array<double, PollingPlanner::BIN_COUNT> hoursWatched{};
+};
+
+// Requests per day if bins with the given rates are polled at c / sqrt(rate), within the interval limits
+double getRequestsPerDay(const std::array<double, PollingPlanner::BIN_COUNT>& rates, const double c) {
+    const double binSeconds = PollingPlanner::Seconds{PollingPlanner::BIN_SIZE}.count();
+
+    double requests = 0.0;
+    for (const double rate : rates) {
+        const double interval = std::clamp(c / std::sqrt(rate), PollingPlanner::MIN_INTERVAL.count(),
+            PollingPlanner::MAX_INTERVAL.count());
+        requests += binSeconds / interval;
+    }
+
+    return requests;
+}
+} // namespace
+
+PollingPlanner::PollingPlanner() {
+    m_intervals.fill(MEAN_INTERVAL);
+}
+
+std::optional<std::string> PollingPlanner::replanIfDue(const std::string_view termCode,
+        const std::vector<Course>& courses) {
+    const auto now = std::chrono::steady_clock::now();
+    if (m_lastPlan && now - *m_lastPlan < REPLAN_INTERVAL) {
+        return std::nullopt;
+    }
+
+    m_lastPlan = now;
+
+    const std::int64_t today = getDay(std::chrono::system_clock::now());
+    BinHistory history;
+    const auto addHistory = [&](const CRN& crn) {
+        for (const DayTally& day : updateTally(termCode, crn).days) {
+            if (day.day < 0 || today - day.day >= LOOKBACK.count()) {
+                continue;
+            }
+
+            for (std::size_t bin = 0; bin < BIN_COUNT; ++bin) {
+                history.openings[bin] += day.openings[bin];
+                history.hoursWatched[bin] += day.hoursWatched[bin];
+            }
+        }
+    };
+
+    for (const Course& course : courses) {
+        addHistory(course.primary);
+        std::ranges::for_each(course.backups, addHistory);
+    }
+
+    const double totalOpenings = std::reduce(history.openings.begin(), history.openings.end());
+    const double totalHours = std::reduce(history.hoursWatched.begin(), history.hoursWatched.end());
+    if (totalOpenings == 0.0 || totalHours == 0.0) {
+        m_intervals.fill(MEAN_INTERVAL);
+        return std::nullopt;
+    }
+
+    const double overallRate = totalOpenings / totalHours;
+    std::array<double, BIN_COUNT> rates{};
+    for (std::size_t bin = 0; bin < BIN_COUNT; ++bin) {
+        rates[bin] = (history.openings[bin] + PRIOR_HOURS * overallRate) / (history.hoursWatched[bin] + PRIOR_HOURS);
+    }
+
+    // Find the scale that spends the same number of requests per day as polling every MEAN_INTERVAL
+    const double budget = std::chrono::days{1} / MEAN_INTERVAL;
+    double low = 1e-9;
+    double high = 1e9;
+    for (int i = 0; i < 200; ++i) {
+        const double middle = std::sqrt(low * high);
+        if (getRequestsPerDay(rates, middle) > budget) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+
+    double weightedInterval = 0.0;
+    for (std::size_t bin = 0; bin < BIN_COUNT; ++bin) {
+        m_intervals[bin] = std::clamp(Seconds{high / std::sqrt(rates[bin])}, MIN_INTERVAL, MAX_INTERVAL);
+        weightedInterval += rates[bin] * m_intervals[bin].count();
+    }
+
+    // On average an opening waits half an interval for the next check
+    const double rateSum = std::reduce(rates.begin(), rates.end());
+    const double expectedLatency = weightedInterval / rateSum / 2.0;
+    const double flatLatency = MEAN_INTERVAL.count() / 2.0;
+    const double requestsPerDay = getRequestsPerDay(rates, high);
+
+    const auto hottest = std::ranges::min_element(m_intervals);
+    const auto hottestStart = BIN_SIZE * static_cast<int>(hottest - m_intervals.begin());
+
+    return fmt::format("Polling plan from {:.0f} opening{} over {:.1f} hours of history: expected capture latency "
+        "{:.2f}s at {:.0f} checks/day ({:.2f}s with a flat interval). Checking every {:.1f}s around {:02}:{:02} UTC.",
+        totalOpenings, determinePlural(static_cast<std::size_t>(totalOpenings)), totalHours, expectedLatency,
+        requestsPerDay, flatLatency, hottest->count(), hottestStart.count() / 60, hottestStart.count() % 60);
+}
+
+PollingPlanner::CrnTally& PollingPlanner::updateTally(const std::string_view termCode, const CRN& crn) {
+    auto it = m_tallies.find(crn.value);
+    if (it == m_tallies.end()) {
+        it = m_tallies.emplace(crn.value, CrnTally{}).first;
+    }
+
+    CrnTally& tally = it->second;
+    const auto getDayTally = [&](const std::chrono::system_clock::time_point time) -> DayTally& {
+        const std::int64_t day = getDay(time);
+        DayTally& dayTally = tally.days[static_cast<std::size_t>(day) % tally.days.size()];
+        if (dayTally.day != day) {
+            dayTally = DayTally{.day = day};
+        }
+
+        return dayTally;
+    };
+
+    const auto after = tally.lastTime.value_or(std::chrono::system_clock::now() - LOOKBACK);
+    SeatHistory::instance().visitStatusesAfter(termCode, crn.value, after,
+        [&](const std::chrono::system_clock::time_point time, const CourseStatus status) {
+            if (tally.lastTime) {
+                if (const auto gap = time - *tally.lastTime; gap <= MAX_OBSERVATION_GAP) {
+                    getDayTally(*tally.lastTime).hoursWatched[getBin(*tally.lastTime)] +=
+                        std::chrono::duration<double, std::ratio<3600>>{gap}.count();
+                }
+
+                if (!isAddable(tally.lastStatus) && isAddable(status)) {
+                    getDayTally(time).openings[getBin(time)] += 1.0;
+                }
+            }
+
+            tally.lastTime = time;
+            tally.lastStatus = status;
+        });
+
+    return tally;
+}
+
+PollingPlanner::Seconds PollingPlanner::nextInterval(std::mt19937& gen) const {
+    const Seconds interval = m_intervals[getBin(std::chrono::system_clock::now())];
+
+    std::uniform_real_distribution dist{interval.count() * (1.0 - JITTER), interval.count() * (1.0 + JITTER)};
+    return Seconds{dist(gen)};
+}
@@ -0,0 +1,70 @@
+#ifndef POLLINGPLANNER_H
+#define POLLINGPLANNER_H
+
+#include "util/Course.h"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Decides how long to wait between seat checks based on when seats have opened before.
+//
+// The day is split into BIN_COUNT bins, and each bin's opening rate is learned from the watched CRNs' seat history
+// (see SeatHistory), smoothed towards the overall rate so that bins with little history don't swing wildly. The
+// same number of checks per day as the old flat 3-6 second interval is then spread across the day in proportion to
+// the square root of each bin's rate, which minimizes the expected time between a seat opening and the next check.
+// Without any history every bin gets the same interval as before.
+//
+// History is tallied per CRN and day as it comes in, so each replan only reads the checks made since the last one
+// and whole days older than LOOKBACK drop out of the tallies.
+class PollingPlanner {
+public:
+    using Seconds = std::chrono::duration<double>;
+
+    static constexpr Seconds MEAN_INTERVAL{4.5};
+    static constexpr Seconds MIN_INTERVAL{2.0};
+    static constexpr Seconds MAX_INTERVAL{30.0};
+    static constexpr std::chrono::minutes BIN_SIZE{15};
+    static constexpr std::size_t BIN_COUNT = std::chrono::days{1} / BIN_SIZE;
+    static constexpr std::chrono::hours REPLAN_INTERVAL{1};
+    static constexpr std::chrono::days LOOKBACK{7};
+
+    PollingPlanner();
+
+    // Rebuilds the plan from the courses' seat history once per REPLAN_INTERVAL. Returns a summary of the new plan
+    // (including its expected capture latency compared to the flat interval) when it was rebuilt.
+    std::optional<std::string> replanIfDue(std::string_view termCode, const std::vector<Course>& courses);
+
+    // Randomized around the current bin's interval
+    [[nodiscard]] Seconds nextInterval(std::mt19937& gen) const;
+
+private:
+    struct DayTally {
+        std::int64_t day = -1; // Days since the epoch, or -1 if unused
+        std::array<double, BIN_COUNT> openings{};
+        std::array<double, BIN_COUNT> hoursWatched{};
+    };
+
+    struct CrnTally {
+        std::optional<std::chrono::system_clock::time_point> lastTime;
+        CourseStatus lastStatus = CourseStatus::Closed;
+        std::array<DayTally, LOOKBACK.count() + 1> days; // Indexed by day modulo their count
+    };
+
+    // Adds the CRN's checks since the last replan to its tally
+    CrnTally& updateTally(std::string_view termCode, const CRN& crn);
+
+    std::array<Seconds, BIN_COUNT> m_intervals;
+    std::map<std::string, CrnTally, std::less<>> m_tallies;
+    std::optional<std::chrono::steady_clock::time_point> m_lastPlan;
+};
+
+#endif // POLLINGPLANNER_H
@@ -0,0 +1,57 @@
+#include "task/SeatWatchSummary.h"
+#include "util/Utility.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+
+void SeatWatchSummary::recordCheck(const bool changed) noexcept {
+    m_checks.fetch_add(1, std::memory_order_relaxed);
+
+    if (changed) {
+        m_changes.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+std::optional<std::string> SeatWatchSummary::takeSummaryIfDue(const std::vector<Course>& courses) {
+    const auto now = std::chrono::steady_clock::now();
+    if (now - m_lastSummary < SUMMARY_INTERVAL) {
+        return std::nullopt;
+    }
+
+    m_lastSummary = now;
+
+    std::size_t watched = 0;
+    std::size_t open = 0;
+    std::size_t waitlist = 0;
+    auto count = [&](const CRN& crn) {
+        if (crn.enrollmentInfo.seats.empty()) {
+            return;
+        }
+
+        ++watched;
+        switch (crn.enrollmentInfo.status) {
+            case CourseStatus::Open:
+                ++open;
+                break;
+            case CourseStatus::WaitlistOpen:
+            case CourseStatus::WaitlistSoon:
+                ++waitlist;
+                break;
+            case CourseStatus::Closed:
+                break;
+        }
+    };
+
+    for (const Course& course : courses) {
+        count(course.primary);
+        std::ranges::for_each(course.backups, count);
+    }
+
+    const std::size_t checks = m_checks.exchange(0, std::memory_order_relaxed);
+    const std::size_t changes = m_changes.exchange(0, std::memory_order_relaxed);
+
+    return fmt::format("Watching {} CRN{}: {} open, {} waitlist, {} closed. {} change{} in {} check{} over the last "
+        "{} minutes.", watched, determinePlural(watched), open, waitlist, watched - open - waitlist,
+        changes, determinePlural(changes), checks, determinePlural(checks), SUMMARY_INTERVAL.count());
+}
@@ -0,0 +1,30 @@
+#ifndef SEATWATCHSUMMARY_H
+#define SEATWATCHSUMMARY_H
+
+#include "util/Course.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Counts seat checks between periodic summaries, since unchanged checks are only logged at debug level.
+class SeatWatchSummary {
+public:
+    static constexpr std::chrono::minutes SUMMARY_INTERVAL{15};
+
+    // Safe to call from the concurrent enrollment checks
+    void recordCheck(bool changed) noexcept;
+
+    // Returns a summary of the courses' current seats and the checks since the last summary, once per interval.
+    [[nodiscard]] std::optional<std::string> takeSummaryIfDue(const std::vector<Course>& courses);
+
+private:
+    std::atomic<std::size_t> m_checks{0};
+    std::atomic<std::size_t> m_changes{0};
+    std::chrono::steady_clock::time_point m_lastSummary = std::chrono::steady_clock::now();
+};
+
+#endif // SEATWATCHSUMMARY_H
@@ -0,0 +1,66 @@
+#include "task/ServerClock.h"
+
+#include <date/date.h>
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+
+namespace {
+// e.g. "Sun, 18 Oct 2026 19:04:05 GMT"
+std::optional<std::chrono::sys_seconds> parseHttpDate(const std::string_view header) {
+    std::istringstream iss{std::string{header}};
+
+    std::chrono::sys_seconds time;
+    iss >> date::parse("%a, %d %b %Y %H:%M:%S GMT", time);
+
+    if (iss.fail()) {
+        return std::nullopt;
+    }
+
+    return time;
+}
+} // namespace
+
+bool ServerClock::addSample(const std::chrono::system_clock::time_point sent,
+        const std::chrono::system_clock::time_point received, const std::string_view dateHeader) {
+    using namespace std::chrono;
+
+    const auto date = parseHttpDate(dateHeader);
+    if (!date) {
+        return false;
+    }
+
+    const auto low = duration_cast<microseconds>(*date - received);
+    const auto high = duration_cast<microseconds>(*date + 1s - sent);
+
+    // The portal's clock stepped (or a response was cached), so the old bounds no longer apply
+    if (low > m_high || high < m_low) {
+        m_low = low;
+        m_high = high;
+        m_roundTrips.clear();
+    } else {
+        m_low = std::max(m_low, low);
+        m_high = std::min(m_high, high);
+    }
+
+    m_roundTrips.push_back(duration_cast<microseconds>(received - sent));
+    return true;
+}
+
+std::optional<ServerClock::Estimate> ServerClock::getEstimate() const {
+    if (m_roundTrips.empty()) {
+        return std::nullopt;
+    }
+
+    std::vector<std::chrono::microseconds> roundTrips = m_roundTrips;
+    const auto middle = roundTrips.begin() + static_cast<std::ptrdiff_t>(roundTrips.size() / 2);
+    std::ranges::nth_element(roundTrips, middle);
+
+    return Estimate{
+        .offset = m_low + (m_high - m_low) / 2,
+        .uncertainty = (m_high - m_low) / 2,
+        .roundTrip = *middle,
+        .samples = m_roundTrips.size()
+    };
+}
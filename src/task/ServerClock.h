@@ -0,0 +1,38 @@
+#ifndef SERVERCLOCK_H
+#define SERVERCLOCK_H
+
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+// Estimates how far the portal's clock is from ours using the Date headers of its responses.
+//
+// Date only has one-second resolution, but a response dated D was produced at some server time in [D, D + 1s), and
+// that happened between sending the request (t0) and receiving the response (t1) by our clock. So each sample bounds
+// the offset (server time - local time) to (D - t1, D + 1s - t0). Intersecting the bounds of samples taken at
+// different points within a second narrows the offset down to about the round trip time, like NTP with coarse
+// timestamps.
+class ServerClock {
+public:
+    struct Estimate {
+        std::chrono::microseconds offset; // Add to local time to get the portal's time
+        std::chrono::microseconds uncertainty; // Either way
+        std::chrono::microseconds roundTrip; // Median
+        std::size_t samples;
+    };
+
+    // Returns false if the header couldn't be parsed
+    bool addSample(std::chrono::system_clock::time_point sent, std::chrono::system_clock::time_point received,
+        std::string_view dateHeader);
+
+    [[nodiscard]] std::optional<Estimate> getEstimate() const;
+
+private:
+    std::chrono::microseconds m_low = std::chrono::microseconds::min();
+    std::chrono::microseconds m_high = std::chrono::microseconds::max();
+    std::vector<std::chrono::microseconds> m_roundTrips;
+};
+
+#endif // SERVERCLOCK_H
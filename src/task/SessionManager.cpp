@@ -1,21 +1,108 @@
 #include "task/SessionManager.h"
 #include "util/Requests.h"
 
+#include <curl/curl.h>
+
+#include <mutex>
 #include <random>
+#include <stdexcept>
+
+struct SessionManager::CookieShare {
+    CookieShare() : handle{curl_share_init()} {
+        if (handle == nullptr) {
+            throw std::runtime_error{"Failed to create curl share handle."};
+        }
+
+        curl_share_setopt(handle, CURLSHOPT_LOCKFUNC, lock);
+        curl_share_setopt(handle, CURLSHOPT_UNLOCKFUNC, unlock);
+        curl_share_setopt(handle, CURLSHOPT_USERDATA, this);
+        curl_share_setopt(handle, CURLSHOPT_SHARE, CURL_LOCK_DATA_COOKIE);
+    }
+
+    ~CookieShare() {
+        curl_share_cleanup(handle);
+    }
+
+    CookieShare(const CookieShare&) = delete;
+    CookieShare& operator=(const CookieShare&) = delete;
+
+    void attach(cpr::Session& session) const {
+        curl_easy_setopt(session.GetCurlHolder()->handle, CURLOPT_SHARE, handle);
+    }
+
+    static void lock(CURL*, curl_lock_data, curl_lock_access, void* share) {
+        static_cast<CookieShare*>(share)->mutex.lock();
+    }
+
+    static void unlock(CURL*, curl_lock_data, void* share) {
+        static_cast<CookieShare*>(share)->mutex.unlock();
+    }
+
+    CURLSH* handle;
+    std::mutex mutex; // Only cookies are shared, so one lock covers everything
+};
+
+namespace {
+std::unique_ptr<cpr::Session> makeSession() {
+    auto session = std::make_unique<cpr::Session>();
+    session->SetRedirect(cpr::Redirect{false});
+    session->SetHeader(getDefaultHeaders());
+
+    return session;
+}
+} // namespace
 
 SessionManager::SessionManager() {
     resetSession();
 }
 
+SessionManager::~SessionManager() = default;
+
 cpr::Session& SessionManager::getSession() const noexcept {
     return *m_session;
 }
 
+cpr::Session& SessionManager::getSideSession() const noexcept {
+    return *m_sideSession;
+}
+
+std::shared_ptr<cpr::Session> SessionManager::getProbeSession(const std::size_t index) {
+    if (index >= MAX_PROBE_SESSIONS) {
+        throw std::out_of_range{"Probe session index out of range."};
+    }
+
+    if (index >= m_probeSessions.size()) {
+        m_probeSessions.resize(index + 1);
+    }
+
+    if (!m_probeSessions[index]) {
+        std::unique_ptr<cpr::Session> session = makeSession();
+        m_cookieShare->attach(*session);
+
+        // The session holds on to the share it's attached to, even if this one gets reset
+        m_probeSessions[index] = std::shared_ptr<cpr::Session>{session.release(),
+            [share = m_cookieShare](const cpr::Session* probeSession) {
+                delete probeSession;
+            }};
+    }
+
+    return m_probeSessions[index];
+}
+
 void SessionManager::resetSession() {
-    m_session = std::make_unique<cpr::Session>();
-    m_session->SetRedirect(cpr::Redirect{false});
-    m_session->SetHeader(getDefaultHeaders());
+    // The share holds the cookies, so a fresh session needs a fresh share
+    m_session.reset();
+    m_sideSession.reset();
+    m_probeSessions.clear();
+    m_cookieShare = std::make_shared<CookieShare>();
+
+    m_session = makeSession();
+    m_sideSession = makeSession();
+    m_cookieShare->attach(*m_session);
+    m_cookieShare->attach(*m_sideSession);
+
     generateUniqueSessionId();
+    navigation = {};
 }
 
 void SessionManager::generateUniqueSessionId() {
@@ -50,4 +137,27 @@ void SessionManager::generateUniqueSessionId() {
         std::chrono::system_clock::now().time_since_epoch()).count());
 
     uniqueSessionId.append(currentUnixTimeMs);
-}
\ No newline at end of file
+}
+std::vector<std::string> SessionManager::exportCookies() const {
+    std::vector<std::string> cookies;
+
+    curl_slist* cookieList = nullptr;
+    if (curl_easy_getinfo(m_session->GetCurlHolder()->handle, CURLINFO_COOKIELIST, &cookieList) != CURLE_OK) {
+        return cookies;
+    }
+
+    for (const curl_slist* node = cookieList; node != nullptr; node = node->next) {
+        cookies.emplace_back(node->data);
+    }
+
+    curl_slist_free_all(cookieList);
+    return cookies;
+}
+
+void SessionManager::importCookies(const std::vector<std::string>& cookies) {
+    CURL* handle = m_session->GetCurlHolder()->handle;
+
+    for (const std::string& cookie : cookies) {
+        curl_easy_setopt(handle, CURLOPT_COOKIELIST, cookie.c_str());
+    }
+}
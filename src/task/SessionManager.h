@@ -3,13 +3,32 @@
 
 #include <cpr/cpr.h>
 
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <optional>
 #include <string>
+#include <vector>
+
+// How far the session has gotten through the portal's pages, so that registration only repeats the steps it needs
+struct NavigationState {
+    std::optional<std::chrono::steady_clock::time_point> verifiedAt; // Last time the session was known to be signed in
+    std::string confirmedTerm; // Selected and confirmed for class registration with the current unique session ID
+    bool visitedClassRegistration = false; // Since the term was confirmed
+    bool modelFresh = false; // The old model matches the portal's registered courses
+};
 
 class SessionManager {
 public:
     SessionManager();
+    ~SessionManager();
 
     [[nodiscard]] cpr::Session& getSession() const noexcept;
+    // Shares the main session's cookies (through a curl share handle), so it can make requests alongside it
+    [[nodiscard]] cpr::Session& getSideSession() const noexcept;
+    // Also shares the main session's cookies, and keeps them alive after resetSession for requests still in flight
+    [[nodiscard]] std::shared_ptr<cpr::Session> getProbeSession(std::size_t index);
+    static constexpr std::size_t MAX_PROBE_SESSIONS = 4;
     void resetSession();
 
     std::string samlResponse;
@@ -17,8 +36,24 @@ public:
     std::string uniqueSessionId;
     void generateUniqueSessionId();
 
+    // Registration cycles since the session was last checked for authentication.
+    int cyclesSinceAuthentication = 0;
+
+    // Reset along with the session and whenever a request fails, so that the next cycle takes every step again
+    NavigationState navigation;
+
+    // Cookies in Netscape cookie file format, one per line, so a session can outlive the process.
+    [[nodiscard]] std::vector<std::string> exportCookies() const;
+    void importCookies(const std::vector<std::string>& cookies);
+
 private:
+    struct CookieShare;
+
+    // Declared first so that it outlives the sessions using it
+    std::shared_ptr<CookieShare> m_cookieShare;
     std::unique_ptr<cpr::Session> m_session;
+    std::unique_ptr<cpr::Session> m_sideSession;
+    std::vector<std::shared_ptr<cpr::Session>> m_probeSessions; // Created on first use
 };
 
 #endif // SESSIONMANAGER_H
\ No newline at end of file
@@ -1,11 +1,21 @@
 #ifndef TASK_H
 #define TASK_H
 
+#include "events/EventLog.h"
+#include "events/SeatEventBus.h"
+#include "registration/HedgedSessions.h"
+#include "registration/OpenProbe.h"
+#include "registration/OpeningBurst.h"
+#include "registration/RequestTemplates.h"
 #include "task/ConfigLoader.h"
 #include "task/CourseManager.h"
+#include "task/FailoverMonitor.h"
+#include "task/LatencyMode.h"
+#include "task/SeatWatchSummary.h"
 #include "task/SessionManager.h"
 #include "task/TaskConfig.h"
 #include "task/TaskLogger.h"
+#include "task/TaskMetrics.h"
 #include "task/TaskScheduler.h"
 
 #include <string_view>
@@ -16,13 +26,35 @@ struct Task {
     explicit Task(std::pair<TaskConfig, std::vector<Course>>&& loaded)
         : config{std::move(loaded.first)},
           courseManager{std::move(loaded.second)},
-          logger{config.cwid, config.termCode, config.enableLogs, config.displayCwid} {}
+          logger{config.cwid, config.termCode, config.enableLogs, config.displayCwid},
+          events{EventLog::instance().registerTask(logger.getId(), logger.hasLogFile())} {}
 
     TaskConfig config;
     CourseManager courseManager;
     SessionManager sessionManager;
+    RequestTemplates requestTemplates; // Registration request bodies, encoded before registration opens
     TaskLogger logger;
+    EventRecorder events; // Hot-path logging that's formatted later on EventLog's thread
     TaskScheduler scheduler;
+    mutable SeatWatchSummary seatWatch;
+    mutable TaskMetrics metrics; // Observational only, so it can be updated through a const Task
+    SeatOpeningInbox seatOpenings; // Openings seen by other tasks watching the same CRNs
+    OpenProbe openProbe; // Watches for registration to open
+    OpeningBurst openingBurst;
+    LatencyMode latencyMode; // Around registration opening, if enabled
+    HedgedSessions hedges; // Declared last so that anything they still have in flight finishes first
+
+    // Set when running as part of an active/standby pair. Standby tasks stay warm but never register.
+    const FailoverMonitor* failover = nullptr;
+
+    [[nodiscard]] bool isActive() const noexcept {
+        return failover == nullptr || failover->isActive();
+    }
+
+    // Checks the lease itself, for right before submitting anything
+    [[nodiscard]] bool confirmActive() const {
+        return failover == nullptr || failover->confirmActive();
+    }
 };
 
 #endif // TASK_H
\ No newline at end of file
@@ -0,0 +1,263 @@
+#include "task/TaskCheckpoint.h"
+#include "util/Utility.h"
+
+#include <fmt/format.h>
+#include <fmt/ranges.h>
+#include <rapidjson/document.h>
+#include <rapidjson/writer.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <optional>
+#include <sstream>
+
+namespace {
+constexpr int CHECKPOINT_VERSION = 2;
+
+std::filesystem::path getCheckpointPath(const Task& task) {
+    const std::string fileName = task.config.name.empty()
+        ? fmt::format("{}-{}", task.config.cwid, task.config.termCode)
+        : sanitizeFileName(task.config.name);
+
+    return getStateDirectory() / (fileName + ".checkpoint.json");
+}
+
+std::string readFile(const std::filesystem::path& path) {
+    std::ifstream file{path, std::ios::binary};
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+bool isString(const rapidjson::Value& json, const char* name) {
+    return json.HasMember(name) && json[name].IsString();
+}
+
+bool isStringArray(const rapidjson::Value& json, const char* name) {
+    return json.HasMember(name) && json[name].IsArray() &&
+        std::ranges::all_of(json[name].GetArray(), [](const rapidjson::Value& value) { return value.IsString(); });
+}
+
+// Returns the first thing wrong with the checkpoint, if anything. Everything restoreCheckpoint() reads is checked
+// here first, so a truncated or hand-edited file is ignored as a whole instead of half restored.
+std::optional<std::string> findMalformedField(const rapidjson::Document& json) {
+    for (const char* name : {"fingerprint", "registrationTime", "uniqueSessionId"}) {
+        if (!isString(json, name)) {
+            return fmt::format("'{}' isn't a string", name);
+        }
+    }
+
+    for (const char* name : {"cookies", "completed", "removed", "pending"}) {
+        if (!isStringArray(json, name)) {
+            return fmt::format("'{}' isn't an array of strings", name);
+        }
+    }
+
+    if (!json.HasMember("savedAt") || !json["savedAt"].IsInt64()) {
+        return "'savedAt' isn't an integer";
+    }
+
+    for (const char* name : {"cyclesSinceAuthentication", "failedCourses"}) {
+        if (!json.HasMember(name) || !json[name].IsInt()) {
+            return fmt::format("'{}' isn't an integer", name);
+        }
+    }
+
+    if (!json.HasMember("courses") || !json["courses"].IsArray()) {
+        return "'courses' isn't an array";
+    }
+
+    for (const auto& details : json["courses"].GetArray()) {
+        if (!details.IsObject() || !isString(details, "crn") || !isString(details, "courseCode") ||
+            !isString(details, "section")) {
+            return "'courses' has an entry without a CRN, course code, and section";
+        }
+    }
+
+    return std::nullopt;
+}
+
+std::vector<std::string> readStringArray(const rapidjson::Document& json, const char* name) {
+    std::vector<std::string> values;
+    for (const auto& value : json[name].GetArray()) {
+        values.emplace_back(value.GetString(), value.GetStringLength());
+    }
+
+    return values;
+}
+
+std::string readString(const rapidjson::Document& json, const char* name) {
+    return std::string{json[name].GetString(), json[name].GetStringLength()};
+}
+
+template <typename Writer>
+void writeString(Writer& writer, const std::string_view value) {
+    writer.String(value.data(), static_cast<rapidjson::SizeType>(value.size()));
+}
+
+template <typename Writer>
+void writeStringArray(Writer& writer, const char* name, const auto& values) {
+    writer.Key(name);
+    writer.StartArray();
+    for (const std::string& value : values) {
+        writeString(writer, value);
+    }
+    writer.EndArray();
+}
+
+std::string serializeCheckpoint(const Task& task) {
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer writer{buffer};
+
+    writer.StartObject();
+
+    writer.Key("version");
+    writer.Int(CHECKPOINT_VERSION);
+    writer.Key("fingerprint");
+    writeString(writer, task.config.fingerprint);
+    writer.Key("savedAt");
+    writer.Int64(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+
+    writer.Key("registrationTime");
+    writeString(writer, task.scheduler.getRegistrationTime());
+    writer.Key("uniqueSessionId");
+    writeString(writer, task.sessionManager.uniqueSessionId);
+    writeStringArray(writer, "cookies", task.sessionManager.exportCookies());
+    writer.Key("cyclesSinceAuthentication");
+    writer.Int(task.sessionManager.cyclesSinceAuthentication);
+
+    // Errors are waited out (portal back up, signed in again) before the cycle's checkpoint is written, so the
+    // failed count is the only failure state still outstanding by then
+    writer.Key("failedCourses");
+    writer.Int(task.courseManager.getFailedCount());
+
+    writer.Key("courses");
+    writer.StartArray();
+    auto writeDetails = [&](const CRN& crn) {
+        if (crn.empty() || crn.courseCode.empty()) {
+            return;
+        }
+
+        writer.StartObject();
+        writer.Key("crn");
+        writeString(writer, crn.value);
+        writer.Key("courseCode");
+        writeString(writer, crn.courseCode);
+        writer.Key("section");
+        writeString(writer, crn.section);
+        writer.EndObject();
+    };
+
+    for (const Course& course : task.courseManager.getCourses()) {
+        writeDetails(course.primary);
+        std::ranges::for_each(course.backups, writeDetails);
+        writeDetails(course.drop);
+    }
+    writer.EndArray();
+
+    writeStringArray(writer, "completed", task.courseManager.getCompletedCrns());
+    writeStringArray(writer, "removed", task.courseManager.getRemovedCrns());
+
+    // Written ahead of submitting a batch so that a crash mid-submission is visible after restarting
+    writeStringArray(writer, "pending", task.courseManager.getRegistrationQueue());
+
+    writer.EndObject();
+
+    return std::string{buffer.GetString(), buffer.GetLength()};
+}
+} // namespace
+
+bool restoreCheckpoint(Task& task, const bool restoreSession) {
+    const auto startTime = std::chrono::steady_clock::now();
+    const std::filesystem::path path = getCheckpointPath(task);
+
+    if (!std::filesystem::exists(path)) {
+        return false;
+    }
+
+    rapidjson::Document json;
+    try {
+        json = parseJsonResponse(readFile(path));
+    } catch (const std::exception& e) {
+        task.logger.warn("Ignoring unreadable checkpoint {}: {}", path.filename().string(), e.what());
+        return false;
+    }
+
+    if (!json.IsObject() || !json.HasMember("version") || !json["version"].IsInt() ||
+        json["version"].GetInt() != CHECKPOINT_VERSION) {
+        task.logger.warn("Ignoring checkpoint {} from an incompatible version.", path.filename().string());
+        return false;
+    }
+
+    if (const auto malformed = findMalformedField(json)) {
+        task.logger.warn("Ignoring malformed checkpoint {}: {}.", path.filename().string(), *malformed);
+        return false;
+    }
+
+    if (readString(json, "fingerprint") != task.config.fingerprint) {
+        task.logger.info("Config changed since the last checkpoint. Starting fresh.");
+        return false;
+    }
+
+    try {
+        if (const std::string registrationTime = readString(json, "registrationTime"); !registrationTime.empty()) {
+            task.scheduler.restoreRegistrationTime(registrationTime);
+        }
+    } catch (const std::exception& e) {
+        task.logger.warn("Could not restore registration time from checkpoint: {}", e.what());
+    }
+
+    if (restoreSession && task.isActive()) {
+        if (std::string sessionId = readString(json, "uniqueSessionId"); !sessionId.empty()) {
+            task.sessionManager.uniqueSessionId = std::move(sessionId);
+        }
+
+        task.sessionManager.importCookies(readStringArray(json, "cookies"));
+        task.sessionManager.cyclesSinceAuthentication = json["cyclesSinceAuthentication"].GetInt();
+    }
+
+    for (const auto& details : json["courses"].GetArray()) {
+        task.courseManager.restoreCourseDetails(
+            details["crn"].GetString(),
+            std::string{details["courseCode"].GetString(), details["courseCode"].GetStringLength()},
+            std::string{details["section"].GetString(), details["section"].GetStringLength()},
+            task.config.termCode
+        );
+    }
+
+    task.courseManager.restoreProgress(readStringArray(json, "completed"), readStringArray(json, "removed"));
+    task.courseManager.restoreFailedCount(json["failedCourses"].GetInt());
+
+    // Checked against the class registration page once the task is signed in (see prepareTask)
+    std::vector<std::string> pending = readStringArray(json, "pending");
+    if (!pending.empty()) {
+        task.logger.warn("CRNs {} may have been submitted right before the last shutdown. "
+            "Checking whether they were registered before submitting them again.", fmt::join(pending, ", "));
+    }
+    task.courseManager.setUnconfirmedCrns(std::move(pending));
+
+    const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime);
+    task.metrics.recordDuration("Restoring checkpoint", duration);
+    task.logger.info("Restored checkpoint in {} ms ({} completed, {} removed, {} remaining course{}).",
+        duration.count(), task.courseManager.getCompletedCrns().size(), task.courseManager.getRemovedCrns().size(),
+        task.courseManager.getCourses().size(), determinePlural(task.courseManager.getCourses().size()));
+
+    return true;
+}
+
+void saveCheckpoint(const Task& task) {
+    // The checkpoint belongs to whichever instance is active
+    if (!task.isActive()) {
+        return;
+    }
+
+    try {
+        // The checkpoint contains session cookies
+        writePrivateFile(getCheckpointPath(task), serializeCheckpoint(task));
+    } catch (const std::exception& e) {
+        task.logger.error("Failed to save checkpoint: {}", e.what());
+    }
+}
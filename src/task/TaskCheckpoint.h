@@ -0,0 +1,17 @@
+#ifndef TASKCHECKPOINT_H
+#define TASKCHECKPOINT_H
+
+#include "task/Task.h"
+
+// Restores a task's progress from its checkpoint (if one exists and matches the config): the registration time,
+// course details, login session, and which CRNs were already completed or removed. Returns true if restored.
+//
+// The login session is only restored on the active instance and with `restoreSession`. A standby taking over keeps
+// its own warm session instead of the one the failed primary was using.
+bool restoreCheckpoint(Task& task, bool restoreSession = true);
+
+// Atomically writes the task's current progress to its checkpoint file. Does nothing on a standby instance.
+// Must be called from the task's own thread since it reads the session's cookies.
+void saveCheckpoint(const Task& task);
+
+#endif // TASKCHECKPOINT_H
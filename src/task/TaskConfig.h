@@ -4,6 +4,7 @@
 #include "util/Course.h"
 
 #include <string>
+#include <vector>
 
 struct TaskConfig {
     std::string cwid;
@@ -13,10 +14,21 @@ struct TaskConfig {
     bool displayCwid = true;
     bool enableLogs = true;
     bool watchForOpenSeats = true;
+    int hibernateMinutesBefore = 15; // 0 keeps the task running while it waits
+    int openProbeIntervalMs = 100; // Between probes for registration opening, across all probe sessions
+    int openProbeSessions = 3;
+    int openProbeWindowSeconds = 60; // After which it only probes once a second
+    std::vector<int> openingBurstMs{-50, 0, 100, 250}; // Offsets from the registration time, empty to only probe
+    int hedgedSessions = 0; // Signed in separately from the main session
+    bool latencyCriticalMode = false; // Linux only
     bool enableNotifications = false;
     std::string discordWebhook;
 
+    // Identifies the login, term, and courses so that checkpoints from a different config are ignored
+    std::string fingerprint;
+
     std::string path;
+    std::string name;
 };
 
 #endif // TASKCONFIG_H
\ No newline at end of file
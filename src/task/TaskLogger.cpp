@@ -1,9 +1,11 @@
 #include "task/TaskLogger.h"
+#include "events/EventLog.h"
+#include "util/FlightRecorderSink.h"
+#include "util/GzipFileSink.h"
 #include "util/Utility.h"
 
 #include <fmt/format.h>
 #include <spdlog/async.h>
-#include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 
 #include <algorithm>
@@ -13,33 +15,24 @@
 #include <vector>
 
 namespace {
-void compressLog(const std::filesystem::path& txtPath) {
-    if (txtPath.empty()) {
-        return;
-    }
-
-    const auto console = spdlog::get("console");
-    if (!std::filesystem::exists(txtPath) || !std::filesystem::is_regular_file(txtPath)) {
-        console->error("Could not compress log file '{}': File does not exist or is not a regular file.",
-            txtPath.filename().string());
-        return;
-    }
-
-    std::filesystem::path gzPath = txtPath;
-    gzPath.replace_extension(".tar.gz");
-    std::filesystem::remove(gzPath);
+constexpr std::size_t MAX_LOG_FILE_SIZE = 16 * 1024 * 1024;
+constexpr std::chrono::hours MAX_LOG_FILE_AGE{24};
+constexpr std::chrono::seconds FLIGHT_RECORDER_WINDOW{120};
+constexpr auto LOG_PATTERN = "[%Y-%m-%d %H:%M:%S.%e] [%l] %v";
 
-    const std::string cmd = fmt::format(R"(tar -C "{}" -czf "{}" "{}")",
-        txtPath.parent_path().string(), gzPath.string(), txtPath.filename().string());
-    if (const int rc = std::system(cmd.c_str()); rc != 0) {
-        console->error("Failed to tar.gz {} (exit code) {}", txtPath.filename().string(), rc);
-        return;
-    }
+std::filesystem::path getLogsDirectory() {
+    return getExecutableDirectory() + "/logs";
+}
 
-    std::filesystem::remove(txtPath);
+std::string getFileTimestamp() {
+    auto timestamp = getCurrentLocalTime();
+    std::ranges::replace(timestamp, ':', '-');
+    std::ranges::replace(timestamp, ' ', '_');
+    return timestamp;
 }
 
-std::vector<spdlog::sink_ptr> makeSinks(const bool logFile, const bool printIds, const std::filesystem::path& path) {
+std::vector<spdlog::sink_ptr> makeSinks(const bool logFile, const bool printIds, const std::filesystem::path& path,
+        const std::shared_ptr<FlightRecorderSink>& flightRecorder) {
     std::vector<spdlog::sink_ptr> sinks;
 
     const auto consoleSink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
@@ -48,10 +41,15 @@ std::vector<spdlog::sink_ptr> makeSinks(const bool logFile, const bool printIds,
     sinks.push_back(consoleSink);
 
     if (logFile) {
-        const auto fileSink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(path.string(), true);
-        fileSink->set_pattern("[%Y-%m-%d %H:%M:%S.%e] [%l] %v");
-        fileSink->set_level(spdlog::level::debug);
+        const auto fileSink = std::make_shared<GzipFileSink>(path, MAX_LOG_FILE_SIZE, MAX_LOG_FILE_AGE);
+        fileSink->set_pattern(LOG_PATTERN);
+        fileSink->set_level(spdlog::level::info);
         sinks.push_back(fileSink);
+
+        // Debug messages only ever end up on disk through a dump
+        flightRecorder->set_pattern(LOG_PATTERN);
+        flightRecorder->set_level(spdlog::level::debug);
+        sinks.push_back(flightRecorder);
     }
 
     return sinks;
@@ -70,27 +68,47 @@ std::string makeTaskId(std::string base, const std::string_view termCode) {
 } // namespace
 
 TaskLogger::TaskLogger(std::string cwid, const std::string_view termCode, const bool logFile, const bool printIds)
-    : m_taskID{makeTaskId(std::move(cwid), termCode)} {
+    : m_taskID{makeTaskId(std::move(cwid), termCode)}, m_logFile{logFile} {
+    std::filesystem::path filePath;
     if (logFile) {
-        const std::filesystem::path logsDirectory = getExecutableDirectory() + "/logs";
+        const std::filesystem::path logsDirectory = getLogsDirectory();
         std::filesystem::create_directory(logsDirectory);
 
-        auto timestamp = getCurrentLocalTime();
-        std::ranges::replace(timestamp, ':', '-');
-        std::ranges::replace(timestamp, ' ', '_');
-        m_filePath = logsDirectory / fmt::format("{}_{}.txt", m_taskID, timestamp);
+        filePath = logsDirectory / fmt::format("{}_{}", m_taskID, getFileTimestamp());
+        m_flightRecorder = std::make_shared<FlightRecorderSink>(FLIGHT_RECORDER_WINDOW);
     }
 
-    auto sinks = makeSinks(logFile, printIds, m_filePath);
+    auto sinks = makeSinks(logFile, printIds, filePath, m_flightRecorder);
     m_logger = std::make_shared<spdlog::async_logger>(m_taskID, sinks.begin(), sinks.end(), spdlog::thread_pool(),
-        spdlog::async_overflow_policy::block);
+        spdlog::async_overflow_policy::overrun_oldest);
     m_logger->set_level(spdlog::level::debug);
-    m_logger->flush_on(spdlog::level::info);
+    // Everything else is flushed periodically (see setupLogging)
+    m_logger->flush_on(spdlog::level::err);
     spdlog::register_logger(m_logger);
 }
 
+std::optional<std::filesystem::path> TaskLogger::dumpFlightRecorder(const std::string_view reason,
+        const bool force) const {
+    if (!m_flightRecorder) {
+        return std::nullopt;
+    }
+
+    const std::filesystem::path path = getLogsDirectory() / fmt::format("{}_flight_{}.txt", m_taskID,
+        getFileTimestamp());
+    if (!m_flightRecorder->requestDump(path, reason, force)) {
+        return std::nullopt;
+    }
+
+    // Hot-path events (stage timings, seat checks) only reach the logger when EventLog drains them
+    EventLog::instance().drainLogger(m_taskID);
+    m_logger->info("Saving recent debug output to {}", path.filename().string());
+
+    // Queued behind everything logged so far, which is when the sink writes the dump
+    m_logger->flush();
+    return path;
+}
+
 TaskLogger::~TaskLogger() {
     m_logger->flush();
     spdlog::drop(m_taskID);
-    compressLog(m_filePath);
 }
\ No newline at end of file
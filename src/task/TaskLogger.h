@@ -5,15 +5,30 @@
 
 #include <filesystem>
 #include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
 
+class FlightRecorderSink;
+
 class TaskLogger {
 public:
     TaskLogger() = default;
     TaskLogger(std::string cwid, std::string_view termCode, bool logFile, bool printIds);
     ~TaskLogger();
 
+    [[nodiscard]] const std::string& getId() const noexcept {
+        return m_taskID;
+    }
+
+    [[nodiscard]] bool hasLogFile() const noexcept {
+        return m_logFile;
+    }
+
+    // Writes the last couple of minutes of messages, debug included, to a file next to the task's log and returns
+    // its path. Does nothing without a log file, or if the last dump was too recent unless forced.
+    std::optional<std::filesystem::path> dumpFlightRecorder(std::string_view reason, bool force = false) const;
+
     void debug(const std::string& str) const {
         m_logger->debug(str);
     }
@@ -61,8 +76,9 @@ public:
 
 private:
     std::string m_taskID;
-    std::filesystem::path m_filePath;
+    bool m_logFile = false;
     std::shared_ptr<spdlog::logger> m_logger;
+    std::shared_ptr<FlightRecorderSink> m_flightRecorder;
 };
 
 
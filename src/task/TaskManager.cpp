@@ -7,9 +7,11 @@
 
 #include <fmt/format.h>
 
+#include <algorithm>
 #include <exception>
 #include <expected>
 #include <iostream>
+#include <ranges>
 
 namespace {
 bool isTxtFile(const std::filesystem::path& path) {
@@ -38,20 +40,66 @@ ExpectedTask createTask(const std::filesystem::path& configPath) {
     }
 }
 
+ExpectedTask createTaskFromString(const std::string& name, const std::string_view contents) {
+    try {
+        return ExpectedTask{std::in_place, std::make_unique<Task>(ConfigLoader::loadFromString(contents))};
+    } catch (const std::exception& e) {
+        return ExpectedTask{std::unexpect, fmt::format("Error creating task {}: {}", name, e.what())};
+    }
+}
+
+TaskStatus makeStatus(const HibernatedTask& hibernated, const std::chrono::steady_clock::time_point now) {
+    return TaskStatus{
+        .name = hibernated.config.name,
+        .cwid = hibernated.config.cwid,
+        .term = hibernated.config.term,
+        .state = "Hibernating",
+        .uptime = std::chrono::duration_cast<std::chrono::milliseconds>(now - hibernated.startTime)
+    };
+}
+
+TaskStatus makeStatus(const TaskHandle& handle, const std::chrono::steady_clock::time_point now) {
+    static constexpr std::chrono::seconds WAIT_TIME{0};
+
+    return TaskStatus{
+        .name = handle.task->config.name,
+        .cwid = handle.task->config.cwid,
+        .term = handle.task->config.term,
+        .state = handle.task->metrics.getState(),
+        .finished = handle.future.valid() && handle.future.wait_for(WAIT_TIME) == std::future_status::ready,
+        .uptime = std::chrono::duration_cast<std::chrono::milliseconds>(now - handle.task->metrics.getStartTime()),
+        .timings = handle.task->metrics.getTimings()
+    };
+}
+
 std::future<void> launchAsyncTask(Task& task) {
     return std::async(std::launch::async, [&task] {
         try {
             prepareTask(task);
             registrationLoop(task);
+            task.metrics.setState("Finished");
         } catch (const TaskCancelled&) {
+            task.metrics.setState("Cancelled");
+        } catch (const TaskHibernating&) {
+            // Picked up by cleanUpFinishedTasks
+            task.metrics.setState("Hibernating");
+            throw;
         } catch (const std::exception& e) {
+            task.metrics.setState("Failed");
             notifyFailure(task, "Exiting Task", e.what());
         }
+
+        // Only this thread can fully leave it, since the mode applies to it
+        task.latencyMode.leave(task.logger);
     });
 }
 } // namespace
 
-TaskManager::TaskManager() {
+TaskManager::TaskManager(const bool useConfigDirectory) : m_useConfigDirectory{useConfigDirectory} {
+    if (!m_useConfigDirectory) {
+        return;
+    }
+
     m_watchId = m_fileWatcher.addWatch(m_configDirectory.string(), this, false);
     if (m_watchId == 0) {
         throw std::runtime_error{"Failed to watch config directory: " + m_configDirectory.string()};
@@ -63,9 +111,33 @@ TaskManager::~TaskManager() {
 }
 
 void TaskManager::start() {
+    if (m_failover) {
+        // Mirror configs the primary accepts over its control socket so they're warm before a takeover
+        if (m_failover->getRole() == InstanceRole::Standby) {
+            std::filesystem::create_directories(m_submittedDirectory);
+            m_submittedWatchId.store(m_fileWatcher.addWatch(m_submittedDirectory.string(), this, false));
+        }
+
+        try {
+            m_failover->start([this] { handleActivation(); }, [this] { stop(); });
+        } catch (const std::exception& e) {
+            spdlog::get("console")->error(e.what());
+            return;
+        }
+    }
+
+    if (m_controlServer) {
+        try {
+            m_controlServer->start();
+        } catch (const std::exception& e) {
+            spdlog::get("console")->error("Failed to start control socket: {}", e.what());
+            m_controlServer.reset();
+        }
+    }
+
     loadInitialTasks();
 
-    if (m_handles.empty()) {
+    if (m_handles.empty() && !keepsRunningWithoutTasks()) {
         const auto console = spdlog::get("console");
         console->info("Please set up at least one valid configuration file in the 'configs' directory.");
         console->info("For guidance, check the wiki at https://github.com/platterss/dare/wiki/Configuration");
@@ -79,7 +151,18 @@ void TaskManager::start() {
 }
 
 void TaskManager::stop() {
-    m_fileWatcher.removeWatch(m_watchId);
+    if (m_watchId != 0) {
+        m_fileWatcher.removeWatch(m_watchId);
+    }
+
+    if (m_controlServer) {
+        m_controlServer->stop();
+    }
+
+    if (m_failover) {
+        m_failover->stop();
+    }
+
     m_shutdownRequested.store(true);
     m_shutdownCv.notify_all();
 }
@@ -135,42 +218,186 @@ void TaskManager::add(const std::filesystem::path& path) {
 
     {
         std::lock_guard lock{m_mutex};
-        for (const auto& [task, future] : m_handles) {
-            if (task->config.path == path.string()) {
-                spdlog::get("console")->info("Task for {} already exists. Skipping.", path.filename().string());
-                return;
-            }
+        const bool exists = std::ranges::any_of(m_handles, [&](const TaskHandle& handle) {
+            return handle.task->config.path == path.string();
+        }) || std::ranges::any_of(m_hibernating, [&](const auto& entry) {
+            return entry.second.config.path == path.string();
+        });
+
+        if (exists) {
+            spdlog::get("console")->info("Task for {} already exists. Skipping.", path.filename().string());
+            return;
         }
     }
 
     launchTask(path);
 }
+
 void TaskManager::remove(const std::filesystem::path& path) {
+    const bool stopped = stopTask([&](const TaskConfig& config) {
+        return config.path == path.string();
+    });
+
+    if (!stopped && !forgetFinished(path.filename().string())) {
+        spdlog::get("console")->warn("No existing task found for {}", path.filename().string());
+    }
+}
+
+bool TaskManager::stopTask(const std::function<bool(const TaskConfig&)>& matches) {
     const auto console = spdlog::get("console");
+    TaskHandle stopping;
 
-    std::lock_guard lock{m_mutex};
-    for (auto it = m_handles.begin(); it != m_handles.end(); ++it) {
-        if (it->task->config.path != path.string()) {
-            continue;
+    {
+        std::lock_guard lock{m_mutex};
+        if (const auto it = std::ranges::find_if(m_hibernating, [&](const auto& entry) {
+                return matches(entry.second.config);
+            }); it != m_hibernating.end()) {
+            console->info("Removing hibernating task for {}", it->second.config.name);
+            m_hibernating.erase(it);
+            return true;
         }
 
-        console->info("Stopping task for {}", path.filename().string());
-        it->task->scheduler.requestStop();
-
-        if (it->future.valid()) {
-            console->info("Waiting for task to finish: {}", path.filename().string());
-            it->future.wait();
+        const auto it = std::ranges::find_if(m_handles, [&](const TaskHandle& handle) {
+            return matches(handle.task->config);
+        });
+        if (it == m_handles.end()) {
+            return false;
         }
 
+        console->info("Stopping task for {}", it->task->config.name);
+        it->task->scheduler.requestStop();
+        stopping = std::move(*it);
         m_handles.erase(it);
-        return;
     }
 
-    console->warn("No existing task found for {}", path.filename().string());
+    // Waited for outside the lock, since the task can take a while to notice and status requests shouldn't stall
+    if (stopping.future.valid()) {
+        console->info("Waiting for task to finish: {}", stopping.task->config.name);
+        stopping.future.wait();
+    }
+
+    return true;
+}
+
+bool TaskManager::forgetFinished(const std::string& name) {
+    std::lock_guard lock{m_mutex};
+    return std::erase_if(m_finished, [&](const TaskStatus& status) {
+        return status.name == name;
+    }) > 0;
+}
+
+void TaskManager::enableControlSocket(std::filesystem::path socketPath) {
+    m_controlServer = std::make_unique<ControlServer>(*this, std::move(socketPath));
+}
+
+void TaskManager::enableFailover(const InstanceRole role) {
+    m_failover = std::make_unique<FailoverMonitor>(role, getStateDirectory());
+}
+
+std::expected<void, std::string> TaskManager::submit(const std::string& name, const std::string_view contents) {
+    // The name doubles as the file name of the saved config
+    if (name.empty() || sanitizeFileName(name) != name) {
+        return std::unexpected{"Task names may only contain letters, digits, '-', '_', and '.'."};
+    }
+
+    auto task = createTaskFromString(name, contents);
+    if (!task) {
+        return std::unexpected{task.error()};
+    }
+
+    // Held until the new task is launched, so that concurrent submits of the same name can't both launch
+    std::lock_guard submitLock{m_submitMutex};
+
+    // Only replace the running task once the new config is known to be valid
+    removeSubmitted(name);
+
+    const std::filesystem::path path = m_submittedDirectory / (name + ".txt");
+    try {
+        // Configs contain passwords
+        std::filesystem::create_directories(m_submittedDirectory);
+        writePrivateFile(path, contents);
+    } catch (const std::exception& e) {
+        return std::unexpected{fmt::format("Failed to save config to {}: {}", path.string(), e.what())};
+    }
+
+    spdlog::get("console")->info("Task submitted through control socket: {}", name);
+    (*task)->config.path = path.string();
+    (*task)->config.name = name;
+    launchHandle(std::move(*task));
+
+    return {};
+}
+
+bool TaskManager::cancel(const std::string& name) {
+    std::lock_guard submitLock{m_submitMutex};
+    return removeSubmitted(name);
+}
+
+bool TaskManager::removeSubmitted(const std::string& name) {
+    const bool stopped = stopTask([&](const TaskConfig& config) {
+        return config.name == name;
+    });
+    const bool forgotten = forgetFinished(name);
+
+    std::error_code ec;
+    std::filesystem::remove(m_submittedDirectory / (name + ".txt"), ec);
+
+    return stopped || forgotten;
+}
+
+void TaskManager::handleActivation() {
+    // From here on this instance owns the submitted configs instead of following the old primary's changes
+    if (const efsw::WatchID watchId = m_submittedWatchId.exchange(0); watchId != 0) {
+        m_fileWatcher.removeWatch(watchId);
+    }
+
+    // Standby tasks notice the takeover on their own. This just wakes the monitor so it re-checks shouldContinue().
+    m_shutdownCv.notify_all();
+}
+
+std::vector<TaskStatus> TaskManager::getStatus() {
+    const auto now = std::chrono::steady_clock::now();
+
+    std::lock_guard lock{m_mutex};
+    std::vector<TaskStatus> statuses = m_finished;
+    statuses.reserve(m_finished.size() + m_handles.size() + m_hibernating.size());
+
+    for (const TaskHandle& handle : m_handles) {
+        statuses.push_back(makeStatus(handle, now));
+    }
+
+    for (const HibernatedTask& hibernated : m_hibernating | std::views::values) {
+        statuses.push_back(makeStatus(hibernated, now));
+    }
+
+    return statuses;
+}
+
+std::expected<std::string, std::string> TaskManager::dump(const std::string& name) {
+    std::lock_guard lock{m_mutex};
+
+    const auto it = std::ranges::find_if(m_handles, [&](const TaskHandle& handle) {
+        return handle.task->config.name == name;
+    });
+    if (it == m_handles.end()) {
+        const bool hibernating = std::ranges::any_of(m_hibernating | std::views::values,
+            [&](const HibernatedTask& hibernated) {
+                return hibernated.config.name == name;
+            });
+        return std::unexpected{hibernating ? "Task is hibernating." : "No running task with that name."};
+    }
+
+    const auto path = it->task->logger.dumpFlightRecorder("Requested over control socket", true);
+    if (!path) {
+        return std::unexpected{"Task has logging disabled."};
+    }
+
+    return path->string();
 }
 
 void TaskManager::loadInitialTasks() {
-    if (!std::filesystem::exists(m_configDirectory) || !std::filesystem::is_directory(m_configDirectory)) {
+    const bool hasConfigs = m_useConfigDirectory && std::filesystem::is_directory(m_configDirectory);
+    if (!hasConfigs && !std::filesystem::is_directory(m_submittedDirectory)) {
         return;
     }
 
@@ -188,22 +415,45 @@ void TaskManager::loadInitialTasks() {
         }
     }
 
-    for (const auto& entry : std::filesystem::directory_iterator{m_configDirectory}) {
+    if (m_useConfigDirectory) {
+        loadTasksFrom(m_configDirectory);
+    }
+
+    loadTasksFrom(m_submittedDirectory);
+}
+
+void TaskManager::loadTasksFrom(const std::filesystem::path& directory) {
+    if (!std::filesystem::is_directory(directory)) {
+        return;
+    }
+
+    for (const auto& entry : std::filesystem::directory_iterator{directory}) {
         launchTask(entry.path());
     }
 }
 
-void TaskManager::launchTask(const std::filesystem::path& path) {
+std::expected<void, std::string> TaskManager::launchTask(const std::filesystem::path& path) {
     auto task = createTask(path);
 
     if (!task) {
         spdlog::get("console")->error(task.error());
-        return;
+        return std::unexpected{task.error()};
     }
 
+    // Submitted configs keep the name they were given over the control socket
+    std::error_code ec;
+    const bool submitted = std::filesystem::equivalent(path.parent_path(), m_submittedDirectory, ec);
+
+    (*task)->config.path = path.string();
+    (*task)->config.name = submitted ? path.stem().string() : path.filename().string();
+    launchHandle(std::move(*task));
+    return {};
+}
+
+void TaskManager::launchHandle(std::unique_ptr<Task> task) {
     TaskHandle handle;
-    handle.task = std::move(*task);
-    handle.task->config.path = path.string();
+    handle.task = std::move(task);
+    handle.task->failover = m_failover.get();
     handle.future = launchAsyncTask(*handle.task);
 
     std::lock_guard lock{m_mutex};
@@ -215,31 +465,83 @@ void TaskManager::cleanUpFinishedTasks() {
     std::vector<TaskHandle> ready;
 
     {
+        const auto now = std::chrono::steady_clock::now();
+
         std::lock_guard lock{m_mutex};
         for (auto it = m_handles.begin(); it != m_handles.end();) {
-            if (it->future.valid() && it->future.wait_for(WAIT_TIME) == std::future_status::ready) {
-                ready.push_back(std::move(*it));
-                it = m_handles.erase(it);
-            } else {
+            if (!it->future.valid() || it->future.wait_for(WAIT_TIME) != std::future_status::ready) {
                 ++it;
+                continue;
             }
+
+            // Hibernating tasks are swapped for their config under the lock so that they never go missing from
+            // status or cancel. The future is ready, so this doesn't block.
+            try {
+                it->future.get();
+            } catch (const TaskHibernating& e) {
+                m_hibernating.emplace(e.wakeTime,
+                    HibernatedTask{std::move(it->task->config), it->task->metrics.getStartTime()});
+                it = m_handles.erase(it);
+                continue;
+            } catch (const std::exception& e) {
+                spdlog::get("console")->error("Error in task {}: {}", it->task->config.name, e.what());
+            }
+
+            addFinished(makeStatus(*it, now));
+            ready.push_back(std::move(*it));
+            it = m_handles.erase(it);
         }
     }
 
-    for (auto& [task, future] : ready) {
-        try {
-            if (future.valid()) {
-                future.get();
-            }
-        } catch (const std::exception& e) {
-            spdlog::get("console")->error("Error in task {}: {}", task->config.path, e.what());
+    // Tasks are destroyed outside the lock since their loggers flush on the way out
+    ready.clear();
+}
+
+void TaskManager::wakeHibernatedTasks() {
+    std::vector<HibernatedTask> due;
+
+    {
+        const auto now = std::chrono::system_clock::now();
+
+        std::lock_guard lock{m_mutex};
+        const auto end = m_hibernating.upper_bound(now);
+        for (auto it = m_hibernating.begin(); it != end; ++it) {
+            due.push_back(std::move(it->second));
         }
+        m_hibernating.erase(m_hibernating.begin(), end);
     }
+
+    for (const HibernatedTask& hibernated : due) {
+        spdlog::get("console")->info("Waking task for {}", hibernated.config.name);
+
+        // A task that can't be relaunched (e.g. its config was edited into something invalid) is reported as
+        // failed rather than silently disappearing
+        if (const auto launched = launchTask(hibernated.config.path); !launched) {
+            TaskStatus status = makeStatus(hibernated, std::chrono::steady_clock::now());
+            status.state = "Failed: " + launched.error();
+            status.finished = true;
+
+            std::lock_guard lock{m_mutex};
+            addFinished(std::move(status));
+        }
+    }
+}
+
+void TaskManager::addFinished(TaskStatus status) {
+    m_finished.push_back(std::move(status));
+    if (m_finished.size() > MAX_FINISHED_STATUSES) {
+        m_finished.erase(m_finished.begin());
+    }
+}
+
+bool TaskManager::keepsRunningWithoutTasks() const noexcept {
+    // A standby has to stay up to take over even if the primary currently has nothing to do
+    return m_controlServer || (m_failover && !m_failover->isActive());
 }
 
 // Runs unlocked
 bool TaskManager::shouldContinue() const noexcept {
-    return !m_handles.empty() && !m_shutdownRequested.load();
+    return (!m_handles.empty() || !m_hibernating.empty() || keepsRunningWithoutTasks()) && !m_shutdownRequested.load();
 }
 
 void TaskManager::monitorTasks() {
@@ -258,6 +560,7 @@ void TaskManager::monitorTasks() {
         }
 
         cleanUpFinishedTasks();
+        wakeHibernatedTasks();
     }
 
     spdlog::get("console")->info("Shutting down.");
@@ -1,14 +1,21 @@
 #ifndef TASKWATCHER_H
 #define TASKWATCHER_H
 
+#include "control/ControlHandler.h"
+#include "control/ControlServer.h"
+#include "task/FailoverMonitor.h"
 #include "task/Task.h"
 #include "util/Utility.h"
 
 #include <atomic>
 #include <chrono>
+#include <expected>
 #include <filesystem>
+#include <functional>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <string_view>
 #include <unordered_map>
 
 #include <efsw/efsw.hpp>
@@ -18,9 +25,17 @@ struct TaskHandle {
     std::future<void> future;
 };
 
-class TaskManager final : public efsw::FileWatchListener {
+// A task waiting for registration without a thread, session, or logger. Everything but its config is restored from
+// its checkpoint when it wakes.
+struct HibernatedTask {
+    TaskConfig config;
+    std::chrono::steady_clock::time_point startTime;
+};
+
+class TaskManager final : public efsw::FileWatchListener, public ControlHandler {
 public:
-    TaskManager();
+    // A worker (see Coordinator) ignores the configs directory and only runs tasks submitted to its control socket.
+    explicit TaskManager(bool useConfigDirectory = true);
     ~TaskManager() override;
 
     void start();
@@ -28,26 +43,62 @@ public:
     void handleFileAction(efsw::WatchID watchID, const std::string& dir, const std::string& filename,
         efsw::Action action, std::string oldName) override;
 
+    // Must be called before start(). Keeps the manager running even when it has no tasks.
+    void enableControlSocket(std::filesystem::path socketPath);
+
+    // Must be called before start(). A standby prepares its tasks but holds off registering until it takes over.
+    void enableFailover(InstanceRole role);
+
+    // The config is saved to the state directory so that it survives a restart or failover.
+    std::expected<void, std::string> submit(const std::string& name, std::string_view contents) override;
+    bool cancel(const std::string& name) override;
+
+    // Finished tasks are included until they're removed, so that a coordinator can tell they're done.
+    std::vector<TaskStatus> getStatus() override;
+    std::expected<std::string, std::string> dump(const std::string& name) override;
+
 private:
     void add(const std::filesystem::path& path);
     void remove(const std::filesystem::path& path);
+    bool stopTask(const std::function<bool(const TaskConfig&)>& matches);
+    bool forgetFinished(const std::string& name);
+    // Requires m_submitMutex
+    bool removeSubmitted(const std::string& name);
+    void handleActivation();
+
+    void loadTasksFrom(const std::filesystem::path& directory);
 
     void loadInitialTasks();
-    void launchTask(const std::filesystem::path& path);
+    std::expected<void, std::string> launchTask(const std::filesystem::path& path);
+    void launchHandle(std::unique_ptr<Task> task);
     void cleanUpFinishedTasks();
+    void wakeHibernatedTasks();
+    // Requires m_mutex
+    void addFinished(TaskStatus status);
+    bool keepsRunningWithoutTasks() const noexcept;
     bool shouldContinue() const noexcept;
     void monitorTasks();
 
     std::atomic<bool> m_shutdownRequested{false};
     std::condition_variable m_shutdownCv;
     std::mutex m_mutex;
+    std::mutex m_submitMutex; // Serializes submit() and cancel(). Never taken while holding m_mutex.
     std::unordered_map<std::string, std::chrono::steady_clock::time_point> m_lastEventTimes;
     std::vector<TaskHandle> m_handles;
+    std::vector<TaskStatus> m_finished;
+    std::multimap<std::chrono::system_clock::time_point, HibernatedTask> m_hibernating; // By wake time
     efsw::FileWatcher m_fileWatcher;
-    efsw::WatchID m_watchId;
+    const bool m_useConfigDirectory;
+    efsw::WatchID m_watchId = 0;
+    std::atomic<efsw::WatchID> m_submittedWatchId{0};
+    std::unique_ptr<ControlServer> m_controlServer;
+    std::unique_ptr<FailoverMonitor> m_failover;
 
     static constexpr std::chrono::milliseconds DEBOUNCE_DURATION{200};
+    // A coordinator removes finished tasks once it has seen them, so this only bounds what nobody collects
+    static constexpr std::size_t MAX_FINISHED_STATUSES = 100;
     const std::filesystem::path m_configDirectory = getExecutableDirectory() + "/configs";
+    const std::filesystem::path m_submittedDirectory = getStateDirectory() / "submitted";
 };
 
 #endif // TASKWATCHER_H
\ No newline at end of file
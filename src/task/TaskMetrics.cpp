@@ -0,0 +1,33 @@
+#include "task/TaskMetrics.h"
+
+void TaskMetrics::recordDuration(const std::string_view stage, const std::chrono::milliseconds duration) {
+    std::lock_guard lock{m_mutex};
+
+    auto it = m_timings.find(stage);
+    if (it == m_timings.end()) {
+        it = m_timings.emplace(std::string{stage}, StageTiming{}).first;
+    }
+
+    it->second.last = duration;
+    it->second.total += duration;
+    ++it->second.count;
+}
+
+void TaskMetrics::setState(std::string state) {
+    std::lock_guard lock{m_mutex};
+    m_state = std::move(state);
+}
+
+std::string TaskMetrics::getState() const {
+    std::lock_guard lock{m_mutex};
+    return m_state;
+}
+
+std::map<std::string, StageTiming, std::less<>> TaskMetrics::getTimings() const {
+    std::lock_guard lock{m_mutex};
+    return m_timings;
+}
+
+std::chrono::steady_clock::time_point TaskMetrics::getStartTime() const noexcept {
+    return m_startTime;
+}
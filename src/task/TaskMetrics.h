@@ -0,0 +1,34 @@
+#ifndef TASKMETRICS_H
+#define TASKMETRICS_H
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+struct StageTiming {
+    std::chrono::milliseconds last{0};
+    std::chrono::milliseconds total{0};
+    std::size_t count = 0;
+};
+
+// Thread-safe snapshot of what a task is doing, readable from outside the task's thread.
+class TaskMetrics {
+public:
+    void recordDuration(std::string_view stage, std::chrono::milliseconds duration);
+    void setState(std::string state);
+
+    [[nodiscard]] std::string getState() const;
+    [[nodiscard]] std::map<std::string, StageTiming, std::less<>> getTimings() const;
+    [[nodiscard]] std::chrono::steady_clock::time_point getStartTime() const noexcept;
+
+private:
+    mutable std::mutex m_mutex;
+    std::string m_state{"Starting"};
+    std::map<std::string, StageTiming, std::less<>> m_timings;
+    const std::chrono::steady_clock::time_point m_startTime = std::chrono::steady_clock::now();
+};
+
+#endif // TASKMETRICS_H
@@ -1,14 +1,19 @@
 #include "task/TaskScheduler.h"
 #include "data/Links.h"
 #include "data/Regexes.h"
+#include "task/ServerClock.h"
 #include "util/Exceptions.h"
 #include "util/Requests.h"
+#include "util/TimeZones.h"
 #include "util/Utility.h"
 
 #include <fmt/format.h>
 
 #include <ctre.hpp>
-#include <date/tz.h>
+#include <date/date.h>
+
+#include <thread>
+#include <utility>
 
 namespace {
 std::chrono::system_clock::time_point parseTime(const std::string_view timeStr) {
@@ -22,10 +27,7 @@ std::chrono::system_clock::time_point parseTime(const std::string_view timeStr)
     }
 
     // Portal displays in Los Angeles time
-    const auto laZone = date::locate_zone("America/Los_Angeles");
-    const date::zoned_time zonedTimePoint{laZone, localTimePoint};
-
-    return zonedTimePoint.get_sys_time();
+    return localToSys("America/Los_Angeles", localTimePoint);
 }
 
 std::string fetchRegistrationTimeHTML(cpr::Session& session, const std::string& term, const std::string& sessionId) {
@@ -71,6 +73,11 @@ void TaskScheduler::saveRegistrationTime(cpr::Session& session, const std::strin
     m_registrationTimePoint = parseTime(m_registrationTimeStr);
 }
 
+void TaskScheduler::restoreRegistrationTime(const std::string& registrationTime) {
+    m_registrationTimePoint = parseTime(registrationTime);
+    m_registrationTimeStr = registrationTime;
+}
+
 const std::string& TaskScheduler::getRegistrationTime() const noexcept {
     return m_registrationTimeStr;
 }
@@ -79,9 +86,92 @@ std::chrono::system_clock::time_point TaskScheduler::getRegistrationTimePoint()
     return m_registrationTimePoint;
 }
 
+void TaskScheduler::hibernateIfEarly(const TaskLogger& logger, const std::chrono::minutes lead) const {
+    using namespace std::chrono;
+
+    if (lead <= 0min) {
+        return;
+    }
+
+    const auto wakeTime = m_registrationTimePoint - lead;
+    if (const auto dur = wakeTime - system_clock::now(); dur > 0s) {
+        const hh_mm_ss hms{duration_cast<seconds>(dur)};
+        logger.info("Hibernating for {:02}h {:02}m {:02}s until {} minutes before registration.",
+            hms.hours().count(), hms.minutes().count(), hms.seconds().count(), lead.count());
+        throw TaskHibernating{wakeTime};
+    }
+}
+
+std::chrono::system_clock::time_point TaskScheduler::getLocalOpeningTime() const noexcept {
+    return m_registrationTimePoint - m_clockOffset;
+}
+
+void TaskScheduler::sleepUntilCalibration(const TaskLogger& logger) {
+    using namespace std::chrono;
+    const auto targetTime = getLocalOpeningTime() - CALIBRATION_LEAD;
+
+    if (system_clock::now() >= targetTime) {
+        return;
+    }
+
+    pauseUntil(logger, targetTime, "before checking the portal's clock");
+}
+
+void TaskScheduler::calibrateClock(cpr::Session& session, const TaskLogger& logger) {
+    using namespace std::chrono;
+
+    // Spacing samples a little over a second apart lands them at different points within the portal's seconds
+    static constexpr auto SAMPLE_INTERVAL = 1s + milliseconds{1000} / CLOCK_SAMPLES;
+
+    // Leave the samples enough time to finish before reauthenticating
+    if (getLocalOpeningTime() - system_clock::now() < SAMPLE_INTERVAL * CLOCK_SAMPLES + 10s) {
+        return;
+    }
+
+    ServerClock clock;
+    for (int i = 0; i < CLOCK_SAMPLES; ++i) {
+        throwIfStopped();
+
+        const auto sent = system_clock::now();
+        const cpr::Response response = sendRequest(session, RequestMethod::HEAD, Link::Reg::REG_DASHBOARD);
+        const auto received = system_clock::now();
+
+        if (const auto it = response.header.find("Date"); it != response.header.end()) {
+            clock.addSample(sent, received, it->second);
+        }
+
+        pauseFor(logger, SAMPLE_INTERVAL);
+    }
+
+    const auto estimate = clock.getEstimate();
+    if (!estimate) {
+        logger.warn("The portal didn't send any usable Date headers. Going by our own clock.");
+        return;
+    }
+
+    m_clockOffset = estimate->offset;
+    logger.info("The portal's clock is {:+.1f}ms from ours (+/- {:.1f}ms, {:.1f}ms round trip, {} samples).",
+        duration<double, std::milli>{estimate->offset}.count(),
+        duration<double, std::milli>{estimate->uncertainty}.count(),
+        duration<double, std::milli>{estimate->roundTrip}.count(), estimate->samples);
+}
+
+bool TaskScheduler::sleepUntilRehearsal(const TaskLogger& logger) {
+    using namespace std::chrono;
+    const auto targetTime = getLocalOpeningTime() - REHEARSAL_LEAD;
+
+    if (system_clock::now() >= targetTime) {
+        return getLocalOpeningTime() - system_clock::now() >= MIN_REHEARSAL_LEAD;
+    }
+
+    pauseUntil(logger, targetTime, "before rehearsing registration");
+    throwIfStopped();
+    return true;
+}
+
 void TaskScheduler::sleepUntilReauthentication(const TaskLogger& logger) {
     using namespace std::chrono;
-    const auto targetTime = m_registrationTimePoint - 5s;
+    const auto targetTime = getLocalOpeningTime() - 5s;
 
     if (system_clock::now() >= targetTime) {
         return;
@@ -92,12 +182,24 @@ void TaskScheduler::sleepUntilReauthentication(const TaskLogger& logger) {
 
 void TaskScheduler::sleepUntilOpen(const TaskLogger& logger) {
     using namespace std::chrono;
+    const auto targetTime = getLocalOpeningTime();
 
-    if (system_clock::now() >= m_registrationTimePoint) {
+    if (system_clock::now() >= targetTime) {
         return;
     }
 
-    pauseUntil(logger, m_registrationTimePoint, "for registration to open");
+    // The condition variable can wake up late, so it only gets close and the rest is spun
+    pauseUntil(logger, targetTime - SPIN_WINDOW, "for registration to open");
+    throwIfStopped();
+
+    auto now = system_clock::now();
+    while (now < targetTime) {
+        std::this_thread::yield();
+        now = system_clock::now();
+    }
+
+    logger.info("Woke up {}us after registration opened by the portal's clock.",
+        duration_cast<microseconds>(now - targetTime).count());
 }
 
 void TaskScheduler::requestStop() noexcept {
@@ -137,4 +239,26 @@ void TaskScheduler::pauseFor(const TaskLogger& logger, const std::chrono::durati
     if (m_stopCv.wait_for(lock, dur, [this] { return m_stopRequested.load(); })) {
         logger.info("Stop requested. Waking up early.");
     }
-}
\ No newline at end of file
+}
+
+void TaskScheduler::wake() noexcept {
+    {
+        std::lock_guard lock{m_stopMutex};
+        m_wakeRequested = true;
+    }
+    m_stopCv.notify_all();
+}
+
+bool TaskScheduler::pauseUntilWoken(const TaskLogger& logger, const std::chrono::duration<double> dur) {
+    std::unique_lock lock{m_stopMutex};
+    if (!m_stopCv.wait_for(lock, dur, [this] { return m_stopRequested.load() || m_wakeRequested; })) {
+        return false;
+    }
+
+    if (m_stopRequested.load()) {
+        logger.info("Stop requested. Waking up early.");
+        return false;
+    }
+
+    return std::exchange(m_wakeRequested, false);
+}
@@ -11,22 +11,46 @@
 class TaskScheduler {
 public:
     void saveRegistrationTime(cpr::Session& session, const std::string& term, const std::string& sessionId);
+    void restoreRegistrationTime(const std::string& registrationTime);
     const std::string& getRegistrationTime() const noexcept;
     std::chrono::system_clock::time_point getRegistrationTimePoint() const noexcept;
+    // When registration opens by our clock, once calibrated
+    std::chrono::system_clock::time_point getLocalOpeningTime() const noexcept;
+    // Throws TaskHibernating if registration opens more than `lead` from now
+    void hibernateIfEarly(const TaskLogger& logger, std::chrono::minutes lead) const;
+    void sleepUntilCalibration(const TaskLogger& logger);
+    // Estimates the portal's clock offset (see ServerClock), which the sleeps until registration then correct for
+    void calibrateClock(cpr::Session& session, const TaskLogger& logger);
+    // Returns false if it's already too close to registration to rehearse it
+    bool sleepUntilRehearsal(const TaskLogger& logger);
     void sleepUntilReauthentication(const TaskLogger& logger);
+    // Sleeps until shortly before registration opens by the portal's clock, then spins until the exact moment
     void sleepUntilOpen(const TaskLogger& logger);
     void requestStop() noexcept;
     void throwIfStopped() const;
     void pauseUntil(const TaskLogger& logger, std::chrono::system_clock::time_point end, const std::string& msg = "");
     void pauseFor(const TaskLogger& logger, std::chrono::duration<double> dur, const std::string& msg = "");
 
+    // Cuts the current pauseUntilWoken short, or makes the next one return right away
+    void wake() noexcept;
+    // Returns true if woken before the duration passed
+    bool pauseUntilWoken(const TaskLogger& logger, std::chrono::duration<double> dur);
+
 private:
+    static constexpr std::chrono::minutes CALIBRATION_LEAD{2};
+    static constexpr int CLOCK_SAMPLES = 12;
+    static constexpr std::chrono::seconds REHEARSAL_LEAD{30};
+    static constexpr std::chrono::seconds MIN_REHEARSAL_LEAD{10};
+    static constexpr std::chrono::milliseconds SPIN_WINDOW{20};
+
     std::string m_registrationTimeStr;
     std::chrono::system_clock::time_point m_registrationTimePoint;
+    std::chrono::microseconds m_clockOffset{0}; // The portal's clock minus ours
 
     std::atomic<bool> m_stopRequested = false;
     std::mutex m_stopMutex;
     std::condition_variable m_stopCv;
+    bool m_wakeRequested = false; // Guarded by m_stopMutex
 };
 
 #endif // TASKSCHEDULER_H
\ No newline at end of file
@@ -0,0 +1,47 @@
+#include "util/AllocationCounter.h"
+
+#ifdef DARE_COUNT_ALLOCATIONS
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+std::atomic<std::uint64_t> allocationCount{0};
+} // namespace
+
+// The other forms of operator new (array, nothrow) forward to this one, and the default operator delete frees what
+// malloc returns, so only this needs replacing. Aligned allocations aren't counted.
+void* operator new(const std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+bool allocationCountingEnabled() noexcept {
+    return true;
+}
+
+std::uint64_t getAllocationCount() noexcept {
+    return allocationCount.load(std::memory_order_relaxed);
+}
+#else
+bool allocationCountingEnabled() noexcept {
+    return false;
+}
+
+std::uint64_t getAllocationCount() noexcept {
+    return 0;
+}
+#endif
@@ -0,0 +1,12 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <cstdint>
+
+// Counts heap allocations made through operator new, across all threads. Only counts when built with
+// DARE_COUNT_ALLOCATIONS (the CMake option of the same name), since counting replaces the global operator new.
+// Otherwise getAllocationCount() is always 0.
+[[nodiscard]] bool allocationCountingEnabled() noexcept;
+[[nodiscard]] std::uint64_t getAllocationCount() noexcept;
+
+#endif // ALLOCATIONCOUNTER_H
@@ -14,6 +14,7 @@
 struct CRN {
     std::string value;
     std::string courseCode;
+    std::string section;
     std::string_view sectionWarning;
     EnrollmentInfo enrollmentInfo;
 
@@ -28,15 +29,15 @@ struct CRN {
         return value == other.value;
     }
 
-    bool operator==(const std::string& crn) const noexcept {
+    bool operator==(const std::string_view crn) const noexcept {
         return value == crn;
     }
 };
 
 template <>
-struct fmt::formatter<CRN> : formatter<std::string> {
+struct fmt::formatter<CRN> : formatter<std::string_view> {
     auto format(const CRN& crn, format_context& ctx) const {
-        return formatter<std::string>::format(fmt::format("[{}] {}", crn.value, crn.courseCode), ctx);
+        return fmt::format_to(ctx.out(), "[{}] {}", crn.value, crn.courseCode);
     }
 };
 
@@ -47,9 +48,9 @@ struct Course {
     bool prioritizeOpenSeats = false;
     bool waitlist = true;
 
-    bool operator==(const std::string& crn) const {
+    bool operator==(const std::string_view crn) const {
         return primary == crn || drop == crn ||
-            std::ranges::any_of(backups, [&crn](const CRN& backup) {
+            std::ranges::any_of(backups, [crn](const CRN& backup) {
                 return backup == crn;
             });
     }
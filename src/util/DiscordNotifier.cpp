@@ -0,0 +1,258 @@
+#include "util/DiscordNotifier.h"
+#include "data/Links.h"
+#include "task/LatencyMode.h"
+#include "util/Requests.h"
+
+#include <cpr/cpr.h>
+#include <rapidjson/document.h>
+#include <rapidjson/writer.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+
+namespace {
+constexpr std::chrono::seconds REQUEST_TIMEOUT{5};
+constexpr int MAX_ATTEMPTS = 5;
+constexpr std::size_t MAX_DESCRIPTION_LENGTH = 4096;
+
+std::string createDiscordBody(const std::vector<DiscordMessage>& messages) {
+    rapidjson::Document document;
+    document.SetObject();
+    auto& allocator = document.GetAllocator();
+
+    auto makeString = [&](const std::string_view value) {
+        return rapidjson::Value(value.data(), static_cast<rapidjson::SizeType>(value.size()), allocator);
+    };
+
+    rapidjson::Value embeds{rapidjson::kArrayType};
+    for (const DiscordMessage& message : messages) {
+        rapidjson::Value embed{rapidjson::kObjectType};
+        embed.AddMember("title", makeString(message.title), allocator);
+        embed.AddMember("description",
+            makeString(std::string_view{message.description}.substr(0, MAX_DESCRIPTION_LENGTH)), allocator);
+        embed.AddMember("timestamp", makeString(message.timestamp), allocator);
+
+        rapidjson::Value footer{rapidjson::kObjectType};
+        footer.AddMember("text", makeString(message.cwid), allocator);
+        embed.AddMember("footer", footer, allocator);
+
+        embeds.PushBack(embed, allocator);
+    }
+
+    document.AddMember("username", rapidjson::StringRef("DARE"), allocator);
+    document.AddMember("avatar_url", rapidjson::StringRef(Link::Discord::PROFILE_PICTURE.data()), allocator);
+    document.AddMember("embeds", embeds, allocator);
+
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer writer{buffer};
+    document.Accept(writer);
+
+    return std::string{buffer.GetString(), buffer.GetLength()};
+}
+
+std::size_t countCharacters(const DiscordMessage& message) {
+    return message.title.size() + std::min(message.description.size(), MAX_DESCRIPTION_LENGTH) + message.cwid.size();
+}
+
+std::chrono::milliseconds parseSeconds(const cpr::Header& header, const std::string& name,
+        const std::chrono::milliseconds fallback) {
+    const auto it = header.find(name);
+    if (it == header.end()) {
+        return fallback;
+    }
+
+    try {
+        // Discord sends fractional seconds in some rate limit headers
+        return std::chrono::milliseconds{static_cast<long long>(std::stod(it->second) * 1000)};
+    } catch (const std::exception&) {
+        return fallback;
+    }
+}
+
+template <typename... Args>
+void logToConsole(const spdlog::level::level_enum level, spdlog::format_string_t<Args...> format, Args&&... args) {
+    // The notifier can outlive the logger registry during static destruction
+    if (const auto console = spdlog::get("console")) {
+        console->log(level, format, std::forward<Args>(args)...);
+    }
+}
+} // namespace
+
+DiscordNotifier& DiscordNotifier::instance() {
+    static DiscordNotifier notifier;
+    return notifier;
+}
+
+DiscordNotifier::~DiscordNotifier() {
+    shutdown(std::chrono::milliseconds{0});
+}
+
+void DiscordNotifier::enqueue(DiscordMessage message) {
+    {
+        std::lock_guard lock{m_mutex};
+        if (m_stopping) {
+            return;
+        }
+
+        if (m_queue.size() >= MAX_QUEUED) {
+            m_queue.pop_front();
+            ++m_dropped;
+        }
+
+        m_queue.push_back(std::move(message));
+
+        // Started on first use so that runs without notifications don't pay for the thread
+        if (!m_future.valid()) {
+            m_future = std::async(std::launch::async, [this] {
+                LatencyMode::releaseCurrentThread();
+                run();
+            });
+        }
+    }
+
+    m_cv.notify_all();
+}
+
+void DiscordNotifier::shutdown(const std::chrono::milliseconds timeout) {
+    {
+        std::lock_guard lock{m_mutex};
+        m_stopping = true;
+        m_deadline = std::min(m_deadline, std::chrono::steady_clock::now() + timeout);
+    }
+
+    m_cv.notify_all();
+
+    if (m_future.valid()) {
+        m_future.wait();
+    }
+}
+
+// Expects m_mutex to be held
+std::vector<DiscordMessage> DiscordNotifier::takeBatch() {
+    std::vector<DiscordMessage> batch;
+    std::size_t characters = 0;
+
+    // Messages for other webhooks keep their place in line for the next batch
+    for (auto it = m_queue.begin(); it != m_queue.end() && batch.size() < MAX_EMBEDS;) {
+        const std::size_t size = countCharacters(*it);
+
+        if (!batch.empty() && (it->webhook != batch.front().webhook || characters + size > MAX_BATCH_CHARACTERS)) {
+            ++it;
+            continue;
+        }
+
+        characters += size;
+        batch.push_back(std::move(*it));
+        it = m_queue.erase(it);
+    }
+
+    return batch;
+}
+
+void DiscordNotifier::run() {
+    cpr::Session session;
+    session.SetHeader(getJsonHeaders());
+    session.SetTimeout(cpr::Timeout{REQUEST_TIMEOUT});
+
+    // Waits until `until` or the shutdown deadline, whichever is first. Returns false once the deadline has passed.
+    auto pauseUntil = [&](const std::chrono::steady_clock::time_point until) {
+        std::unique_lock lock{m_mutex};
+        m_cv.wait_until(lock, std::min(until, m_deadline), [&] {
+            return std::chrono::steady_clock::now() >= m_deadline;
+        });
+
+        return std::chrono::steady_clock::now() < m_deadline;
+    };
+
+    // Caps the request timeout to what's left before the shutdown deadline. Returns false once it has passed.
+    auto fitToDeadline = [&] {
+        std::chrono::steady_clock::time_point deadline;
+        {
+            std::lock_guard lock{m_mutex};
+            deadline = m_deadline;
+        }
+
+        const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now());
+        if (left.count() <= 0) {
+            return false;
+        }
+
+        session.SetTimeout(cpr::Timeout{std::min<std::chrono::milliseconds>(REQUEST_TIMEOUT, left)});
+        return true;
+    };
+
+    while (true) {
+        std::vector<DiscordMessage> batch;
+        std::size_t dropped;
+
+        {
+            std::unique_lock lock{m_mutex};
+            m_cv.wait(lock, [&] {
+                return m_stopping || !m_queue.empty();
+            });
+
+            if (m_queue.empty()) {
+                return;
+            }
+
+            if (!m_stopping) {
+                m_cv.wait_for(lock, BATCH_DELAY, [&] {
+                    return m_stopping;
+                });
+            }
+
+            batch = takeBatch();
+            dropped = std::exchange(m_dropped, 0);
+        }
+
+        if (dropped > 0) {
+            logToConsole(spdlog::level::warn, "Dropped {} Discord notification{} because Discord fell behind.",
+                dropped, dropped == 1 ? "" : "s");
+        }
+
+        session.SetUrl(cpr::Url{batch.front().webhook});
+        session.SetBody(cpr::Body{createDiscordBody(batch)});
+
+        for (int attempt = 1; attempt <= MAX_ATTEMPTS; ++attempt) {
+            if (!fitToDeadline()) {
+                logToConsole(spdlog::level::warn, "Shut down before sending {} Discord notification{}.",
+                    batch.size(), batch.size() == 1 ? "" : "s");
+                return;
+            }
+
+            const cpr::Response response = session.Post();
+
+            if (cpr::status::is_success(response.status_code)) {
+                // Wait out the bucket instead of sending into a guaranteed 429
+                if (const auto it = response.header.find("X-RateLimit-Remaining");
+                    it != response.header.end() && it->second == "0") {
+                    const auto resetAfter = parseSeconds(response.header, "X-RateLimit-Reset-After",
+                        std::chrono::seconds{1});
+                    if (!pauseUntil(std::chrono::steady_clock::now() + resetAfter)) {
+                        return;
+                    }
+                }
+
+                break;
+            }
+
+            const bool rateLimited = response.status_code == 429;
+            const bool transient = response.status_code == 0 || cpr::status::is_server_error(response.status_code);
+
+            if ((!rateLimited && !transient) || attempt == MAX_ATTEMPTS) {
+                logToConsole(spdlog::level::err, "Discord Webhook Error: HTTP {} for {} message{} to CWID {}",
+                    response.status_code, batch.size(), batch.size() == 1 ? "" : "s", batch.front().cwid);
+                break;
+            }
+
+            const auto wait = rateLimited
+                ? parseSeconds(response.header, "Retry-After", std::chrono::seconds{1})
+                : std::chrono::milliseconds{500 << attempt};
+
+            if (!pauseUntil(std::chrono::steady_clock::now() + wait)) {
+                return;
+            }
+        }
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef DISCORDNOTIFIER_H
+#define DISCORDNOTIFIER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct DiscordMessage {
+    std::string webhook;
+    std::string cwid;
+    std::string title;
+    std::string description;
+    std::string timestamp;
+};
+
+// Delivers Discord webhook messages from a background thread so that registration never waits on Discord.
+//
+// Messages for the same webhook are packed into a single request of up to MAX_EMBEDS embeds over one
+// persistent session. A 429 pauses sending for as long as Discord's Retry-After asks. If the queue fills
+// up faster than Discord accepts messages, the oldest ones are dropped.
+class DiscordNotifier {
+public:
+    static DiscordNotifier& instance();
+
+    DiscordNotifier(const DiscordNotifier&) = delete;
+    DiscordNotifier& operator=(const DiscordNotifier&) = delete;
+
+    // Never blocks on the network.
+    void enqueue(DiscordMessage message);
+
+    // Stops accepting messages and gives the queue up to `timeout` to drain.
+    void shutdown(std::chrono::milliseconds timeout);
+
+private:
+    DiscordNotifier() = default;
+    ~DiscordNotifier();
+
+    std::vector<DiscordMessage> takeBatch();
+    void run();
+
+    static constexpr std::size_t MAX_QUEUED = 256;
+    static constexpr std::size_t MAX_EMBEDS = 10;
+    static constexpr std::size_t MAX_BATCH_CHARACTERS = 6000;
+
+    // Gives messages produced together (e.g. one registration cycle's results) a moment to join the same request
+    static constexpr std::chrono::milliseconds BATCH_DELAY{200};
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<DiscordMessage> m_queue;
+    std::size_t m_dropped = 0;
+    bool m_stopping = false;
+    std::chrono::steady_clock::time_point m_deadline = std::chrono::steady_clock::time_point::max();
+    std::future<void> m_future;
+};
+
+#endif // DISCORDNOTIFIER_H
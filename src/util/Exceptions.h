@@ -1,6 +1,7 @@
 #ifndef EXCEPTIONS_H
 #define EXCEPTIONS_H
 
+#include <chrono>
 #include <stdexcept>
 
 struct UnrecoverableException final : std::runtime_error {
@@ -13,4 +14,16 @@ struct TaskCancelled final : std::exception {
     }
 };
 
+// Thrown by a task that's waiting for registration to give up its thread and resources. TaskManager recreates the
+// task from its config and checkpoint at wakeTime.
+struct TaskHibernating final : std::exception {
+    explicit TaskHibernating(const std::chrono::system_clock::time_point wakeTime) noexcept : wakeTime{wakeTime} {}
+
+    [[nodiscard]] const char* what() const noexcept override {
+        return "The task is hibernating until shortly before registration.";
+    }
+
+    std::chrono::system_clock::time_point wakeTime;
+};
+
 #endif // EXCEPTIONS_H
\ No newline at end of file
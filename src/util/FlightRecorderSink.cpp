@@ -0,0 +1,74 @@
+#include "util/FlightRecorderSink.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <fstream>
+
+FlightRecorderSink::FlightRecorderSink(const std::chrono::seconds window) : m_window{window} {}
+
+bool FlightRecorderSink::requestDump(std::filesystem::path path, const std::string_view reason, const bool force) {
+    std::lock_guard lock{mutex_};
+
+    const auto now = std::chrono::steady_clock::now();
+    if (!force && m_lastDump && now - *m_lastDump < MIN_DUMP_INTERVAL) {
+        return false;
+    }
+
+    m_lastDump = now;
+    m_pendingDump = PendingDump{std::move(path), std::string{reason}, spdlog::log_clock::now()};
+    return true;
+}
+
+void FlightRecorderSink::sink_it_(const spdlog::details::log_msg& msg) {
+    Entry& entry = m_entries[m_next];
+    entry.time = msg.time;
+    entry.level = msg.level;
+    entry.length = static_cast<std::uint16_t>(std::min(msg.payload.size(), MESSAGE_SIZE));
+    std::copy_n(msg.payload.data(), entry.length, entry.text.begin());
+
+    m_next = (m_next + 1) % CAPACITY;
+    m_size = std::min(m_size + 1, CAPACITY);
+}
+
+void FlightRecorderSink::flush_() {
+    if (!m_pendingDump) {
+        return;
+    }
+
+    const PendingDump dump = std::move(*m_pendingDump);
+    m_pendingDump.reset();
+
+    try {
+        writeDump(dump);
+    } catch (const std::exception& e) {
+        fmt::print(stderr, "Failed to write flight recorder dump {}: {}\n", dump.path.string(), e.what());
+    }
+}
+
+void FlightRecorderSink::writeDump(const PendingDump& dump) const {
+    std::ofstream file{dump.path, std::ios::trunc};
+    if (!file) {
+        throw spdlog::spdlog_ex{"Failed to open " + dump.path.string()};
+    }
+
+    file << "Flight recorder dump: " << dump.reason << '\n';
+
+    const auto since = dump.requestedAt - m_window;
+    spdlog::memory_buf_t line;
+
+    // Oldest first. Anything logged after the request (but before the flush) is included too.
+    for (std::size_t i = 0; i < m_size; ++i) {
+        const Entry& entry = m_entries[(m_next + CAPACITY - m_size + i) % CAPACITY];
+        if (entry.time < since) {
+            continue;
+        }
+
+        const spdlog::details::log_msg msg{entry.time, spdlog::source_loc{}, spdlog::string_view_t{},
+            entry.level, spdlog::string_view_t{entry.text.data(), entry.length}};
+
+        line.clear();
+        formatter_->format(msg, line);
+        file.write(line.data(), static_cast<std::streamsize>(line.size()));
+    }
+}
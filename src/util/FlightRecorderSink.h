@@ -0,0 +1,67 @@
+#ifndef FLIGHTRECORDERSINK_H
+#define FLIGHTRECORDERSINK_H
+
+#include <spdlog/sinks/base_sink.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// spdlog sink that keeps a task's most recent messages (debug included) in a fixed-size ring in memory.
+//
+// Nothing is written out until a dump is requested. The dump itself happens on the logger's thread when the logger
+// is next flushed, so it includes every message logged before the request (TaskLogger drains the task's EventLog
+// events into the logger first). Messages longer than MESSAGE_SIZE are truncated, and once the ring is full the
+// oldest message is overwritten.
+class FlightRecorderSink final : public spdlog::sinks::base_sink<std::mutex> {
+public:
+    static constexpr std::size_t CAPACITY = 1024;
+    static constexpr std::size_t MESSAGE_SIZE = 128;
+
+    // Dumps cover the last `window` of messages
+    explicit FlightRecorderSink(std::chrono::seconds window);
+
+    // Schedules the ring to be written to `path` on the next flush. Unless forced, the request is ignored (and
+    // false returned) if the last dump was less than MIN_DUMP_INTERVAL ago, so a task stuck in an error loop
+    // doesn't leave a dump behind for every attempt.
+    bool requestDump(std::filesystem::path path, std::string_view reason, bool force);
+
+protected:
+    void sink_it_(const spdlog::details::log_msg& msg) override;
+    void flush_() override;
+
+private:
+    struct Entry {
+        spdlog::log_clock::time_point time;
+        spdlog::level::level_enum level = spdlog::level::off;
+        std::uint16_t length = 0;
+        std::array<char, MESSAGE_SIZE> text{};
+    };
+
+    struct PendingDump {
+        std::filesystem::path path;
+        std::string reason;
+        spdlog::log_clock::time_point requestedAt;
+    };
+
+    void writeDump(const PendingDump& dump) const;
+
+    static constexpr std::chrono::minutes MIN_DUMP_INTERVAL{1};
+
+    const std::chrono::seconds m_window;
+
+    std::array<Entry, CAPACITY> m_entries{};
+    std::size_t m_next = 0;
+    std::size_t m_size = 0;
+
+    std::optional<PendingDump> m_pendingDump;
+    std::optional<std::chrono::steady_clock::time_point> m_lastDump;
+};
+
+#endif // FLIGHTRECORDERSINK_H
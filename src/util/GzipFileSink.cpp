@@ -0,0 +1,112 @@
+#include "util/GzipFileSink.h"
+
+#include <fmt/format.h>
+
+namespace {
+// 15 window bits plus 16 selects a gzip header and trailer instead of raw zlib
+constexpr int GZIP_WINDOW_BITS = 15 + 16;
+constexpr int MEMORY_LEVEL = 8;
+} // namespace
+
+GzipFileSink::GzipFileSink(std::filesystem::path basePath, const std::size_t maxFileSize,
+        const std::chrono::minutes maxFileAge)
+    : m_basePath{std::move(basePath)}, m_maxFileSize{maxFileSize}, m_maxFileAge{maxFileAge} {
+    openFile();
+}
+
+GzipFileSink::~GzipFileSink() {
+    std::lock_guard lock{mutex_};
+
+    try {
+        closeFile();
+    } catch (const std::exception& e) {
+        fmt::print(stderr, "Failed to finish log file {}: {}\n", m_basePath.string(), e.what());
+    }
+}
+
+void GzipFileSink::sink_it_(const spdlog::details::log_msg& msg) {
+    formatter_->format(msg, m_pending);
+
+    if (m_pending.size() >= BATCH_SIZE) {
+        compress(Z_NO_FLUSH);
+    }
+
+    if (shouldRotate()) {
+        closeFile();
+        openFile();
+    }
+}
+
+void GzipFileSink::flush_() {
+    if (m_pending.size() == 0 && !m_unflushed) {
+        return;
+    }
+
+    // A sync flush ends on a byte boundary, so everything so far can be read back even if the process dies later
+    compress(Z_SYNC_FLUSH);
+    m_file.flush();
+    m_unflushed = false;
+}
+
+void GzipFileSink::openFile() {
+    ++m_fileCount;
+
+    std::filesystem::path path = m_basePath;
+    path += m_fileCount == 1 ? ".txt.gz" : fmt::format(".{}.txt.gz", m_fileCount);
+
+    m_file.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_file) {
+        throw spdlog::spdlog_ex{"Failed to open log file " + path.string()};
+    }
+
+    m_stream = z_stream{};
+    if (deflateInit2(&m_stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, GZIP_WINDOW_BITS, MEMORY_LEVEL,
+        Z_DEFAULT_STRATEGY) != Z_OK) {
+        m_file.close();
+        throw spdlog::spdlog_ex{"Failed to initialize compression for " + path.string()};
+    }
+
+    m_open = true;
+    m_openedAt = std::chrono::steady_clock::now();
+}
+
+void GzipFileSink::closeFile() {
+    if (!m_open) {
+        return;
+    }
+
+    // Writes the remaining data and the gzip trailer
+    compress(Z_FINISH);
+    deflateEnd(&m_stream);
+    m_file.close();
+    m_open = false;
+}
+
+void GzipFileSink::compress(const int flushMode) {
+    m_stream.next_in = reinterpret_cast<Bytef*>(m_pending.data());
+    m_stream.avail_in = static_cast<uInt>(m_pending.size());
+
+    do {
+        m_stream.next_out = m_output.data();
+        m_stream.avail_out = static_cast<uInt>(m_output.size());
+
+        // Z_BUF_ERROR only means there was nothing new to compress
+        if (const int result = deflate(&m_stream, flushMode); result == Z_STREAM_ERROR) {
+            throw spdlog::spdlog_ex{"Failed to compress log output"};
+        }
+
+        m_file.write(reinterpret_cast<const char*>(m_output.data()),
+            static_cast<std::streamsize>(m_output.size() - m_stream.avail_out));
+    } while (m_stream.avail_out == 0);
+
+    m_pending.clear();
+    m_unflushed = flushMode == Z_NO_FLUSH;
+
+    if (!m_file) {
+        throw spdlog::spdlog_ex{"Failed to write log file " + m_basePath.string()};
+    }
+}
+
+bool GzipFileSink::shouldRotate() const {
+    return m_stream.total_out >= m_maxFileSize || std::chrono::steady_clock::now() - m_openedAt >= m_maxFileAge;
+}
@@ -0,0 +1,52 @@
+#ifndef GZIPFILESINK_H
+#define GZIPFILESINK_H
+
+#include <spdlog/sinks/base_sink.h>
+#include <zlib.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+
+// spdlog sink that gzip-compresses lines in-process as they're logged.
+//
+// Formatted lines are collected in memory and compressed BATCH_SIZE bytes at a time, so the disk is only touched
+// when a batch fills up or the logger is flushed. Every file is a complete .gz of its own. Once a file reaches
+// maxFileSize compressed bytes or has been open for maxFileAge, it's finished and the next part is started:
+// `<base>.txt.gz`, `<base>.2.txt.gz`, `<base>.3.txt.gz`, ...
+class GzipFileSink final : public spdlog::sinks::base_sink<std::mutex> {
+public:
+    GzipFileSink(std::filesystem::path basePath, std::size_t maxFileSize, std::chrono::minutes maxFileAge);
+    ~GzipFileSink() override;
+
+protected:
+    void sink_it_(const spdlog::details::log_msg& msg) override;
+    void flush_() override;
+
+private:
+    void openFile();
+    void closeFile();
+    void compress(int flushMode);
+    [[nodiscard]] bool shouldRotate() const;
+
+    static constexpr std::size_t BATCH_SIZE = 64 * 1024;
+
+    const std::filesystem::path m_basePath;
+    const std::size_t m_maxFileSize;
+    const std::chrono::minutes m_maxFileAge;
+
+    std::ofstream m_file;
+    z_stream m_stream{};
+    bool m_open = false;
+    bool m_unflushed = false;
+    std::size_t m_fileCount = 0;
+    std::chrono::steady_clock::time_point m_openedAt;
+
+    spdlog::memory_buf_t m_pending;
+    std::array<unsigned char, 16 * 1024> m_output{};
+};
+
+#endif // GZIPFILESINK_H
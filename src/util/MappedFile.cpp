@@ -0,0 +1,130 @@
+#include "util/MappedFile.h"
+
+#include <fmt/format.h>
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(_WIN32)
+MappedFile::MappedFile(const std::filesystem::path& path) {
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error{fmt::format("Failed to open {}.", path.string())};
+    }
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        throw std::runtime_error{fmt::format("{} is empty.", path.string())};
+    }
+
+    // The mapping keeps its own reference to the file
+    m_mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (m_mapping == nullptr) {
+        throw std::runtime_error{fmt::format("Failed to map {}.", path.string())};
+    }
+
+    m_data = static_cast<std::byte*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (m_data == nullptr) {
+        CloseHandle(m_mapping);
+        throw std::runtime_error{fmt::format("Failed to map {}.", path.string())};
+    }
+
+    m_size = static_cast<std::size_t>(size.QuadPart);
+}
+
+MappedFile::MappedFile(const std::filesystem::path& path, const std::size_t size) {
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_DELETE,
+        nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error{fmt::format("Failed to open {}.", path.string())};
+    }
+
+    LARGE_INTEGER fileSize{};
+    fileSize.QuadPart = static_cast<LONGLONG>(size);
+    if (!SetFilePointerEx(file, fileSize, nullptr, FILE_BEGIN) || !SetEndOfFile(file)) {
+        CloseHandle(file);
+        throw std::runtime_error{fmt::format("Failed to resize {}.", path.string())};
+    }
+
+    m_mapping = CreateFileMappingW(file, nullptr, PAGE_READWRITE, 0, 0, nullptr);
+    CloseHandle(file);
+    if (m_mapping == nullptr) {
+        throw std::runtime_error{fmt::format("Failed to map {}.", path.string())};
+    }
+
+    m_data = static_cast<std::byte*>(MapViewOfFile(m_mapping, FILE_MAP_WRITE, 0, 0, 0));
+    if (m_data == nullptr) {
+        CloseHandle(m_mapping);
+        throw std::runtime_error{fmt::format("Failed to map {}.", path.string())};
+    }
+
+    m_size = size;
+}
+
+MappedFile::~MappedFile() {
+    UnmapViewOfFile(m_data);
+    CloseHandle(m_mapping);
+}
+#else
+MappedFile::MappedFile(const std::filesystem::path& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error{fmt::format("Failed to open {}: {}", path.string(), std::strerror(errno))};
+    }
+
+    struct stat info{};
+    if (::fstat(fd, &info) != 0 || info.st_size == 0) {
+        ::close(fd);
+        throw std::runtime_error{fmt::format("{} is empty.", path.string())};
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    void* data = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        throw std::runtime_error{fmt::format("Failed to map {}: {}", path.string(), std::strerror(errno))};
+    }
+
+    m_data = static_cast<std::byte*>(data);
+    m_size = static_cast<std::size_t>(info.st_size);
+}
+
+MappedFile::MappedFile(const std::filesystem::path& path, const std::size_t size) {
+    const int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0600);
+    if (fd < 0) {
+        throw std::runtime_error{fmt::format("Failed to open {}: {}", path.string(), std::strerror(errno))};
+    }
+
+    if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        const std::string error = std::strerror(errno);
+        ::close(fd);
+        throw std::runtime_error{fmt::format("Failed to resize {}: {}", path.string(), error)};
+    }
+
+    void* data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        throw std::runtime_error{fmt::format("Failed to map {}: {}", path.string(), std::strerror(errno))};
+    }
+
+    m_data = static_cast<std::byte*>(data);
+    m_size = size;
+}
+
+MappedFile::~MappedFile() {
+    ::munmap(m_data, m_size);
+}
+#endif
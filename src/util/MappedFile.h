@@ -0,0 +1,41 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+// A whole file mapped into memory. Replacing the file by renaming over it doesn't affect an existing mapping.
+class MappedFile {
+public:
+    // Maps the file read-only. Throws if the file can't be opened or mapped, or is empty.
+    explicit MappedFile(const std::filesystem::path& path);
+
+    // Creates the file if needed, resizes it to `size` bytes, and maps it read-write. Writes go straight to the
+    // page cache and reach the file whenever the OS writes them back, even if the process crashes.
+    MappedFile(const std::filesystem::path& path, std::size_t size);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    [[nodiscard]] std::span<const std::byte> getData() const noexcept {
+        return {m_data, m_size};
+    }
+
+    // Only for files mapped read-write
+    [[nodiscard]] std::span<std::byte> getWritableData() const noexcept {
+        return {m_data, m_size};
+    }
+
+private:
+    std::byte* m_data = nullptr;
+    std::size_t m_size = 0;
+
+#if defined(_WIN32)
+    void* m_mapping = nullptr;
+#endif
+};
+
+#endif // MAPPEDFILE_H
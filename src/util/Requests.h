@@ -34,16 +34,16 @@ cpr::Response sendRequest(cpr::Session& session, const RequestMethod method, con
     return response;
 }
 
-// Sends a Discord notification to the Task's webhook URL.
+// Queues a Discord notification to the Task's webhook URL. Returns immediately; see DiscordNotifier.
 void sendDiscordNotification(const Task& task, const std::string& title, const std::string& message);
 
 // Checks if MyPortal is down.
 bool portalIsDown();
 
 // Gets the url encoded headers used for most requests.
-cpr::Header getDefaultHeaders();
+const cpr::Header& getDefaultHeaders();
 
 // Gets the headers used for sending requests with JSON bodies.
-cpr::Header getJsonHeaders();
+const cpr::Header& getJsonHeaders();
 
 #endif // REQUESTS_H
\ No newline at end of file
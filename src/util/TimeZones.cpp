@@ -0,0 +1,136 @@
+#include "util/TimeZones.h"
+#include "util/Utility.h"
+
+#include <date/tz.h>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+
+namespace {
+using namespace std::chrono_literals;
+
+struct Transition {
+    std::chrono::sys_seconds at;
+
+    // UTC offset from `at` until the next transition
+    std::chrono::seconds offset;
+};
+
+struct EmbeddedZone {
+    std::string_view name;
+    std::chrono::seconds standardOffset;
+    std::chrono::seconds daylightOffset;
+    std::span<const Transition> transitions;
+};
+
+// The current US daylight saving time rules took effect in 2007
+constexpr int FIRST_YEAR = 2007;
+constexpr int LAST_YEAR = 2099;
+constexpr std::size_t YEAR_COUNT = LAST_YEAR - FIRST_YEAR + 1;
+
+// Daylight saving time runs from 2:00 local time on the second Sunday of March to 2:00 local time on the first
+// Sunday of November.
+constexpr std::array<Transition, YEAR_COUNT * 2> makeUsTransitions(const std::chrono::seconds standardOffset) {
+    using namespace std::chrono;
+
+    const seconds daylightOffset = standardOffset + 1h;
+    std::array<Transition, YEAR_COUNT * 2> transitions{};
+
+    for (std::size_t i = 0; i < YEAR_COUNT; ++i) {
+        const year year{FIRST_YEAR + static_cast<int>(i)};
+        const sys_days daylightStart{year / March / Sunday[2]};
+        const sys_days daylightEnd{year / November / Sunday[1]};
+
+        transitions[i * 2] = Transition{daylightStart + 2h - standardOffset, daylightOffset};
+        transitions[i * 2 + 1] = Transition{daylightEnd + 2h - daylightOffset, standardOffset};
+    }
+
+    return transitions;
+}
+
+constexpr auto LOS_ANGELES_TRANSITIONS = makeUsTransitions(-8h);
+
+// 2025-03-09 10:00 UTC (2:00 PST) and 2025-11-02 09:00 UTC (2:00 PDT)
+static_assert(LOS_ANGELES_TRANSITIONS[(2025 - FIRST_YEAR) * 2].at ==
+    std::chrono::sys_days{std::chrono::year{2025} / 3 / 9} + 10h);
+static_assert(LOS_ANGELES_TRANSITIONS[(2025 - FIRST_YEAR) * 2 + 1].at ==
+    std::chrono::sys_days{std::chrono::year{2025} / 11 / 2} + 9h);
+
+constexpr std::array EMBEDDED_ZONES{
+    EmbeddedZone{"America/Los_Angeles", -8h, -7h, LOS_ANGELES_TRANSITIONS}
+};
+
+// Returns std::nullopt if the time isn't covered by the zone's table
+std::optional<std::chrono::seconds> getOffset(const EmbeddedZone& zone, const std::chrono::sys_seconds time) {
+    if (time < zone.transitions.front().at || time >= zone.transitions.back().at) {
+        return std::nullopt;
+    }
+
+    const auto next = std::ranges::upper_bound(zone.transitions, time, {}, &Transition::at);
+    return std::prev(next)->offset;
+}
+
+// Returns std::nullopt if the time isn't covered by the zone's table
+std::optional<std::chrono::sys_seconds> convertEmbedded(const EmbeddedZone& zone,
+        const date::local_time<std::chrono::seconds> localTime) {
+    std::optional<std::chrono::sys_seconds> result;
+
+    // A local time is valid under an offset if converting it with that offset lands where the offset applies
+    for (const std::chrono::seconds offset : {zone.standardOffset, zone.daylightOffset}) {
+        const std::chrono::sys_seconds candidate{localTime.time_since_epoch() - offset};
+
+        const auto actualOffset = getOffset(zone, candidate);
+        if (!actualOffset) {
+            return std::nullopt;
+        }
+
+        if (*actualOffset != offset) {
+            continue;
+        }
+
+        if (result) {
+            throw std::runtime_error{fmt::format("Local time is ambiguous in {} (daylight saving time ends).",
+                zone.name)};
+        }
+
+        result = candidate;
+    }
+
+    if (!result) {
+        throw std::runtime_error{fmt::format("Local time doesn't exist in {} (daylight saving time starts).",
+            zone.name)};
+    }
+
+    return result;
+}
+
+std::chrono::sys_seconds convertWithDatabase(const std::string_view zoneName,
+        const date::local_time<std::chrono::seconds> localTime) {
+    static std::once_flag installed;
+    std::call_once(installed, [] {
+        date::set_install((std::filesystem::path{getExecutableDirectory()} / "tzdata").string());
+    });
+
+    const date::zoned_time zonedTime{date::locate_zone(std::string{zoneName}), localTime};
+    return zonedTime.get_sys_time();
+}
+} // namespace
+
+std::chrono::sys_seconds localToSys(const std::string_view zoneName,
+        const date::local_time<std::chrono::seconds> localTime) {
+    if (const auto zone = std::ranges::find(EMBEDDED_ZONES, zoneName, &EmbeddedZone::name);
+            zone != EMBEDDED_ZONES.end()) {
+        if (const auto result = convertEmbedded(*zone, localTime)) {
+            return *result;
+        }
+    }
+
+    return convertWithDatabase(zoneName, localTime);
+}
@@ -0,0 +1,17 @@
+#ifndef TIMEZONES_H
+#define TIMEZONES_H
+
+#include <date/date.h>
+
+#include <chrono>
+#include <string_view>
+
+// Converts a local time in the given IANA time zone to UTC.
+//
+// Zones with rules compiled into the program (currently just America/Los_Angeles, which the portal uses) are
+// converted with a table lookup. Any other zone, or a time outside the compiled-in years, goes through the full tz
+// database in the `tzdata` folder next to the executable, which is only loaded the first time that happens.
+// Throws if the local time is skipped or repeated by a daylight saving time change.
+std::chrono::sys_seconds localToSys(std::string_view zoneName, date::local_time<std::chrono::seconds> localTime);
+
+#endif // TIMEZONES_H
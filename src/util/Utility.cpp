@@ -2,18 +2,28 @@
 
 #include <fmt/format.h>
 
+#include <algorithm>
+#include <cctype>
 #include <charconv>
 #include <filesystem>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <mutex>
 #include <sstream>
 
 #if defined(_WIN32)
 #include <windows.h>
 #elif defined(__APPLE__)
 #include <mach-o/dyld.h>
-#elif defined(__linux__)
+#endif
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <fcntl.h>
 #include <unistd.h>
+
+#include <cerrno>
+#include <system_error>
 #endif
 
 rapidjson::Document parseJsonResponse(const std::string_view response) {
@@ -38,6 +48,17 @@ rapidjson::Document parseJsonResponse(const std::string_view response, rapidjson
     return json;
 }
 
+rapidjson::Document parseJsonInsitu(char* buffer, rapidjson::MemoryPoolAllocator<>* allocator) {
+    rapidjson::Document json{allocator};
+    json.ParseInsitu(buffer);
+
+    if (json.HasParseError()) {
+        throw std::runtime_error{"Failed to parse JSON response: " + std::to_string(json.GetParseError())};
+    }
+
+    return json;
+}
+
 std::string getCurrentLocalTime() {
     const auto now = std::chrono::system_clock::now();
     std::time_t now_time = std::chrono::system_clock::to_time_t(now);
@@ -93,6 +114,95 @@ std::string getExecutableDirectory() {
     return std::filesystem::canonical(path).parent_path().string();
 }
 
+namespace {
+std::filesystem::path g_stateDirectory;
+std::once_flag g_stateDirectoryCreated;
+} // namespace
+
+std::filesystem::path getStateDirectory() {
+    // Only checked once, since checkpoints ask for it every cycle. A failed attempt is retried on the next call.
+    std::call_once(g_stateDirectoryCreated, [] {
+        if (g_stateDirectory.empty()) {
+            g_stateDirectory = std::filesystem::path{getExecutableDirectory()} / "state";
+        }
+
+        // Checkpoints and submitted configs in it hold session cookies and passwords
+        if (std::filesystem::create_directories(g_stateDirectory)) {
+            std::filesystem::permissions(g_stateDirectory, std::filesystem::perms::owner_all,
+                std::filesystem::perm_options::replace);
+        }
+    });
+
+    return g_stateDirectory;
+}
+
+void setStateDirectory(std::filesystem::path directory) {
+    g_stateDirectory = std::move(directory);
+}
+
+void writePrivateFile(const std::filesystem::path& path, const std::string_view contents) {
+    std::filesystem::path tempPath = path;
+    tempPath += ".tmp";
+
+#if defined(__linux__) || defined(__APPLE__)
+    // Created private rather than made private after writing, so the contents are never readable by anyone else.
+    // A leftover from a crash mid-write is replaced, since O_EXCL won't open it.
+    std::filesystem::remove(tempPath);
+    const int fd = ::open(tempPath.c_str(), O_CREAT | O_EXCL | O_WRONLY, 0600);
+    if (fd < 0) {
+        throw std::system_error{errno, std::generic_category(), "Failed to create " + tempPath.string()};
+    }
+
+    std::string_view remaining = contents;
+    while (!remaining.empty()) {
+        const ssize_t written = ::write(fd, remaining.data(), remaining.size());
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (written <= 0) {
+            const int error = errno;
+            ::close(fd);
+            throw std::system_error{error, std::generic_category(), "Failed to write " + tempPath.string()};
+        }
+
+        remaining.remove_prefix(static_cast<std::size_t>(written));
+    }
+
+    if (::close(fd) != 0) {
+        throw std::system_error{errno, std::generic_category(), "Failed to write " + tempPath.string()};
+    }
+#else
+    {
+        std::ofstream file{tempPath, std::ios::binary | std::ios::trunc};
+        file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+        file.flush();
+
+        if (!file) {
+            throw std::runtime_error{"Failed to write " + tempPath.string()};
+        }
+    }
+
+    std::filesystem::permissions(tempPath,
+        std::filesystem::perms::owner_read | std::filesystem::perms::owner_write,
+        std::filesystem::perm_options::replace);
+#endif
+
+    // Renaming over the old file means a crash mid-write never leaves a partial file behind
+    std::filesystem::rename(tempPath, path);
+}
+
+std::uint64_t fnv1a(const std::string_view data, std::uint64_t hash) {
+    static constexpr std::uint64_t FNV1A_PRIME = 1099511628211ULL;
+
+    for (const unsigned char c : data) {
+        hash ^= c;
+        hash *= FNV1A_PRIME;
+    }
+
+    return hash;
+}
+
 std::string convert12HourTo24Hour(const std::string_view time12) {
     const auto firstSpace = time12.find(' ');
     if (firstSpace == std::string_view::npos) {
@@ -149,6 +259,16 @@ std::string_view trimSurroundingChars(const std::string_view sv, const std::stri
     return sv.substr(start, end - start + 1);
 }
 
+std::string sanitizeFileName(const std::string_view name) {
+    std::string sanitized{name};
+
+    std::ranges::replace_if(sanitized, [](const char c) {
+        return !(std::isalnum(static_cast<unsigned char>(c)) || c == '-' || c == '_' || c == '.');
+    }, '_');
+
+    return sanitized;
+}
+
 int parseInt(const std::string_view sv) {
     int value{};
 
@@ -164,8 +284,8 @@ std::string determinePlural(const std::size_t size) {
     return size == 1 ? "" : "s";
 }
 
-std::string formatCourseCode(const std::string& subject, const std::string& courseNumber) {
-    std::string courseCode = subject + ' ' + courseNumber;
+std::string formatCourseCode(const std::string_view subject, const std::string_view courseNumber) {
+    std::string courseCode = fmt::format("{} {}", subject, courseNumber);
 
     // The dot looks ugly when we put a hyphen next to it
     if (courseCode.back() == '.') {
@@ -3,17 +3,52 @@
 
 #include <rapidjson/document.h>
 
+#include <cstdint>
+#include <filesystem>
+#include <functional>
 #include <ranges>
 #include <string>
 #include <string_view>
+#include <unordered_set>
 #include <vector>
 
+// Lets string sets be searched with string_views (e.g. CRNs pointing into a response) without copying them
+struct StringHash {
+    using is_transparent = void;
+
+    std::size_t operator()(const std::string_view sv) const noexcept {
+        return std::hash<std::string_view>{}(sv);
+    }
+};
+
+using StringSet = std::unordered_set<std::string, StringHash, std::equal_to<>>;
+
 rapidjson::Document parseJsonResponse(std::string_view response);
 rapidjson::Document parseJsonResponse(std::string_view response, rapidjson::MemoryPoolAllocator<>* allocator);
+
+// Parses in place, so strings in the document point into (and modify) the buffer instead of being copied. The
+// buffer must be null-terminated and outlive the document.
+rapidjson::Document parseJsonInsitu(char* buffer, rapidjson::MemoryPoolAllocator<>* allocator = nullptr);
 std::string getCurrentLocalTime();
 std::string getCurrentUTCTime();
 std::string getExecutableDirectory();
 
+// Directory for state that should survive restarts (checkpoints, caches). Created on the first call if missing.
+// Defaults to `state` next to the executable.
+std::filesystem::path getStateDirectory();
+
+// Overrides the state directory, e.g. to share it between an active and a standby instance. Call before anything
+// uses the state directory.
+void setStateDirectory(std::filesystem::path directory);
+
+// Atomically replaces the file with the contents, readable and writable only by the owner. Throws on failure.
+void writePrivateFile(const std::filesystem::path& path, std::string_view contents);
+
+inline constexpr std::uint64_t FNV1A_OFFSET_BASIS = 14695981039346656037ULL;
+
+// 64-bit FNV-1a. Pass a previous result as the hash to continue hashing across several values.
+std::uint64_t fnv1a(std::string_view data, std::uint64_t hash = FNV1A_OFFSET_BASIS);
+
 // Accepts a string in the format MM/DD/YYYY HH:MM AM (ex. 07/24/2025 10:00 AM)
 std::string convert12HourTo24Hour(std::string_view time12);
 
@@ -23,9 +58,12 @@ std::string_view clampBetween(std::string_view sv, std::string_view begin, std::
 // Trims characters from both ends. Defaults to trimming whitespace.
 std::string_view trimSurroundingChars(std::string_view sv, std::string_view chars = " \t\v\r\n");
 
+// Replaces anything other than letters, digits, '-', '_', and '.' with '_'.
+std::string sanitizeFileName(std::string_view name);
+
 int parseInt(std::string_view sv);
 std::string determinePlural(std::size_t size);
-std::string formatCourseCode(const std::string& subject, const std::string& courseNumber);
+std::string formatCourseCode(std::string_view subject, std::string_view courseNumber);
 std::vector<std::string> split(std::string_view str, std::string_view delimiter);
 
 #endif // UTILITY_H
\ No newline at end of file